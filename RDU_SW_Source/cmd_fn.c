@@ -85,6 +85,8 @@
 #define	ENUM_101	set_offset
 #define	CMD_102		"ptts"
 #define	ENUM_102	pttsub
+#define	CMD_103		"plls"			// PLL sweep/regression check
+#define	ENUM_103	pll_swp
 #define	CMD_11		"p"
 #define	ENUM_11		tst_pwm
 #define	CMD_12		"e"
@@ -109,6 +111,14 @@
 #define	ENUM_19		tstuart1
 #define	CMD_20		"scan"
 #define	ENUM_20		scan_cmd
+#define	CMD_201		"sin"			// SIN diagnostics
+#define	ENUM_201	sin_stat
+#define	CMD_202		"scap"			// SIN capture/replay
+#define	ENUM_202	sin_capt
+#define	CMD_203		"sout"			// SOUT bus budget
+#define	ENUM_203	sout_stat
+#define	CMD_204		"strc"			// SOUT trace/latency histograms
+#define	ENUM_204	sout_trc
 #define	CMD_21		"sto"			// store memory data
 #define	ENUM_21		sto_mem
 #define	CMD_210		"s"				// squelch
@@ -129,16 +139,18 @@
 #define	ENUM_26		vers
 #define	CMD_27		"v"			// version info
 #define	ENUM_27		volc
+#define	CMD_28		"xit"			// UX-129 X/RIT pulse sequencer
+#define	ENUM_28		xitc
 #define	ENUM_LAST	lastcmd
 
 
-char* cmd_list[] = { CMD_1, CMD_2, CMD_3, CMD_31, CMD_32, CMD_4, CMD_41, CMD_5, CMD_6, CMD_7, CMD_8, CMD_81, CMD_9, CMD_10, CMD_101, CMD_102, CMD_11, \
-				     CMD_12, CMD_13, CMD_131, CMD_14, CMD_15, CMD_160, CMD_16, CMD_17, CMD_18, CMD_19, CMD_20, CMD_21, CMD_210, CMD_211, CMD_212, CMD_213, \
-				     CMD_22, CMD_23, CMD_24, CMD_26, CMD_27, "\xff" };
+char* cmd_list[] = { CMD_1, CMD_2, CMD_3, CMD_31, CMD_32, CMD_4, CMD_41, CMD_5, CMD_6, CMD_7, CMD_8, CMD_81, CMD_9, CMD_10, CMD_101, CMD_102, CMD_103, CMD_11, \
+				     CMD_12, CMD_13, CMD_131, CMD_14, CMD_15, CMD_160, CMD_16, CMD_17, CMD_18, CMD_19, CMD_20, CMD_201, CMD_202, CMD_203, CMD_204, CMD_21, CMD_210, CMD_211, CMD_212, CMD_213, \
+				     CMD_22, CMD_23, CMD_24, CMD_26, CMD_27, CMD_28, "\xff" };
 
-enum       cmd_enum{ ENUM_1, ENUM_2, ENUM_3, ENUM_31, ENUM_32, ENUM_4, ENUM_41, ENUM_5, ENUM_6, ENUM_7, ENUM_8, ENUM_81, ENUM_9, ENUM_10, ENUM_101, ENUM_102, ENUM_11, \
-	   	   	   	   	 ENUM_12, ENUM_13, ENUM_131, ENUM_14, ENUM_15, ENUM_160, ENUM_16, ENUM_17, ENUM_18, ENUM_19, ENUM_20, ENUM_21, ENUM_210, ENUM_211, ENUM_212, ENUM_213, \
-					 ENUM_22, ENUM_23, ENUM_24, ENUM_26, ENUM_27, ENUM_LAST };
+enum       cmd_enum{ ENUM_1, ENUM_2, ENUM_3, ENUM_31, ENUM_32, ENUM_4, ENUM_41, ENUM_5, ENUM_6, ENUM_7, ENUM_8, ENUM_81, ENUM_9, ENUM_10, ENUM_101, ENUM_102, ENUM_103, ENUM_11, \
+	   	   	   	   	 ENUM_12, ENUM_13, ENUM_131, ENUM_14, ENUM_15, ENUM_160, ENUM_16, ENUM_17, ENUM_18, ENUM_19, ENUM_20, ENUM_201, ENUM_202, ENUM_203, ENUM_204, ENUM_21, ENUM_210, ENUM_211, ENUM_212, ENUM_213, \
+					 ENUM_22, ENUM_23, ENUM_24, ENUM_26, ENUM_27, ENUM_28, ENUM_LAST };
 
 // enum error message ID
 enum err_enum{ no_response, no_device, target_timeout };
@@ -342,6 +354,7 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 	U8		j;						// temp
 	U8		l;						// temp
 	S32		mem_buf8[7];			// U8 mem buffer
+	U8		mem_rec[MEM_LEN];		// packed mem record
 //	U8*		ptr0;					// U8 mem pointer
 	U16		k;						// U16 temp
 	U16		kk;						// U16 temp
@@ -439,7 +452,9 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 					putsQ(obuf);
 					sprintf(obuf,"NUM_MEMS = %d", NUM_MEMS);
 					putsQ(obuf);
-					sprintf(obuf,"Last NVRAM = %d (0x%04x)", MEM_END,MEM_END);
+					sprintf(obuf,"Last NVRAM = %d (0x%04x)", NVMIG_END,NVMIG_END);
+					putsQ(obuf);
+					sprintf(obuf,"Last live NVRAM = %d (0x%04x)", SCANIX_END,SCANIX_END);
 					putsQ(obuf);
 					sprintf(obuf,"NVREV = 0x%04x", nvram_sn());
 					putsQ(obuf);
@@ -566,23 +581,11 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 							sprintf(obuf,"#ERRCHKS = %d$", kk);
 							putsQ(obuf);
 						}else{
-							kk = get_memaddr((U8)params[0], (U8)params[1]);
-							rw32_nvr(kk, ii, CS_WRITE|CS_OPEN);						// write freq
-							rw16_nvr(kk, (U16)hh, CS_WRITE);						// write offs
-							rw8_nvr(kk, (U8)mem_buf8[0], CS_WRITE);					// duplex/pwr/skip
-							rw8_nvr(kk, lookup_pl(k)+1, CS_WRITE);					// PL tone code
-							rw8_nvr(kk, (U8)mem_buf8[2], CS_WRITE);					// sq
-							rw8_nvr(kk, 0, CS_WRITE);								// vol deprecated (vfo_p[band].vol now a spare) //
-							rw8_nvr(kk, (U8)mem_buf8[4], CS_WRITE);					// xit
-							rw8_nvr(kk, (U8)mem_buf8[5], CS_WRITE);					// rit
-							rw8_nvr(kk, (U8)mem_buf8[6], CS_WRITE|CS_CLOSE);					// bid
-							kk = get_memaddr((U8)params[0], (U8)params[1]) + MEM_STR_ADDR;			// band/mem#
-							j = CS_WRITE | CS_OPEN;											// namestr
-							for(i=0; i<MEM_NAME_LEN; i++){
-								if(i == (MEM_NAME_LEN - 1)) j = CS_WRITE | CS_CLOSE;
-								rw8_nvr(kk, *t++, j);
-								j = CS_WRITE;
-							}
+							pack_mem(mem_rec, ii, (U16)hh, (U8)mem_buf8[0], lookup_pl(k)+1, (U8)mem_buf8[2],	// freq, offs, duplex/pwr/skip, PL tone code, sq
+									 (U8)mem_buf8[4], (U8)mem_buf8[5], (U8)mem_buf8[6], t);					// xit, rit, bid, namestr
+							nvr_write_mem((U8)params[0], (U8)params[1], mem_rec);
+							mcache_inval((U8)params[0], (U8)params[1]);
+							scanix_upd((U8)params[0], (U8)params[1], (U8)mem_buf8[0] & SCANEN_F);
 							putsQ("#OK$");
 						}
 					}else{
@@ -599,21 +602,13 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 					params[1] = mem2ordinal(args[2][0]);						// convert mem chr to mem#
 					if(--params[0] > 5) params[1] = NUM_MEMS;
 					if(params[1] < NUM_MEMS){
-						ii = get_memaddr((U8)params[0], (U8)params[1]) + MEM_STR_ADDR;			// band/mem#
+						ii = get_mnameaddr((U8)params[0], (U8)params[1]);		// band/mem#
 						if(args[3][0] != '\0'){									// copy new string to NVRAM
-							j = CS_WRITE | CS_OPEN;
-							for(i=0; i<MEM_NAME_LEN; i++){
-								if(i == (MEM_NAME_LEN - 1)) j = CS_WRITE | CS_CLOSE;
-								rw8_nvr(ii, args[3][i], j);
-								j = CS_WRITE;
-							}
-						}
-						j = CS_READ | CS_OPEN;									// read NVRAM
-						for(i=0; i<MEM_NAME_LEN; i++){
-							if(i == (MEM_NAME_LEN - 1)) j = CS_READ | CS_CLOSE;
-							gp_buf[i] = rw8_nvr(ii, 0, j);
-							j = CS_READ;
+							nvr_write_block(ii, (U8*)args[3], MEM_NAME_LEN);
+							mcache_inval((U8)params[0], (U8)params[1]);
 						}
+						nvr_read_block(ii, (U8*)gp_buf, MEM_NAME_LEN);			// read NVRAM
+						gp_buf[MEM_NAME_LEN] = '\0';
 //						if(params[1] < NUM_MEMS){
 							sprintf(obuf,"MEM String, %s: #: %c, '%s'\n", band_str[params[0]], ordinal2mem(params[1]), gp_buf);
 							putsQ(obuf);
@@ -728,6 +723,22 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 						}
 						break;
 
+					case xitc:														// xit: p[0] = pulse count, p[1] = 1 for up, -c clears done count
+						if(*args[1] && (*args[1] != '-')){
+							params[0] = 0;
+							params[1] = 0;
+							get_Dargs(1, nargs, args, params);						// parse param numerics into params[] array
+							if(params[0] <= REG_XIT_CNT){
+								xit_seq_start((U8)params[0] | (params[1] ? REG_XIT_UP : 0));
+							}else{
+								putsQ("#ERR$");
+							}
+						}
+						i = get_xit_stat(&k, pc);
+						sprintf(obuf,"X/RIT: %u pulses pending, %u trains done", i, k);
+						putsQ(obuf);
+						break;
+
 					case squc:														// squ: p[0] = mid, p[1] = squ
 						params[0] = 99;
 						params[1] = 99;
@@ -842,6 +853,7 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 							set_bandnv();
 							set_vnv(MAIN);
 							set_vnv(SUB);
+							nvc_flush(1);
 							putsQ("#OK$");
 						}else{
 							putsQ("#ERR$");
@@ -888,6 +900,73 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 					putsQ("doscan");
 					break;
 
+				case pll_swp:													// PLL frame sweep, timing, and golden CRC check
+					putsQ("PLL sweep...");
+					pll_sweep();
+					break;
+
+				case sin_stat:													// SIN telemetry, p[0] = vote mode, -c clears stats
+					if(*args[1] && (*args[1] != '-')){
+						get_Dargs(1, nargs, args, params);						// parse param numerics into params[] array
+						set_sin_vote((U8)params[0]);
+					}
+					print_sin_stat(pc);
+					sprintf(obuf,"SIN evq ovr: %u", get_sin_evor(pc));
+					putsQ(obuf);
+					break;
+
+				case sout_stat:													// SOUT bus budget, -c clears peak and counts
+					sprintf(obuf,"SOUT util: %u%% (peak %u%%) of %u frames/sec", get_sout_util(), get_sout_peak(pc), (U16)SOUT_BW_CAP);
+					putsQ(obuf);
+					sprintf(obuf,"SOUT deferred: %u, coalesced: %u", get_sout_bwdef(pc), get_sout_coal(pc));
+					putsQ(obuf);
+					break;
+
+				case sout_trc:													// SOUT trace: p[0] = H for latency histograms, -c clears
+					if((args[1][0] == 'h') || (args[1][0] == 'H')){
+						lat_hist_dump();
+					}else{
+						sout_trace_dump();
+					}
+					if(pc) clr_sout_trace();
+					break;
+
+				case sin_capt:													// SIN capture/replay: p[0] = mode or D/R/W, -c clears buffer
+					if(pc){
+						sin_cap_clr();
+					}
+					switch(args[1][0]){
+						case 'd':
+						case 'D':
+							sin_cap_dump();										// list capture buffer
+							break;
+
+						case 'r':
+						case 'R':
+							sin_replay(1);										// replay capture buffer through process_SIN()
+							putsQ("replay...");
+							break;
+
+						case 'w':
+						case 'W':
+							params[0] = 0;										// load a frame: W <dt ms> <hex word>
+							get_Dargs(2, nargs, args, params);
+							get_BCD32(args[3], &ii);
+							if(!sin_cap_put(params[0], ii)) putsQ("SCAP full/busy");
+							break;
+
+						case '\0':
+							break;
+
+						default:
+							get_Dargs(1, nargs, args, params);					// capture mode
+							sin_cap_mode((U8)params[0]);
+							break;
+					}
+					sprintf(obuf,"SCAP: %d frames", sin_cap_len());
+					putsQ(obuf);
+					break;
+
 				case hm_cmd:													// process HM-133 MFmic data stream intercepts
 /*					putsQ("\n{hmc:");
 					putsQ(args[0]);		// debug !!!
@@ -945,6 +1024,7 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 					params[0] = 0;
 					params[1] = 0;
 					get_Dargs(1, nargs, args, params);							// parse param numerics into params[] array
+					nvc_flush(1);												// show the VFO cache contents, not stale NVRAM
 					if(params[1] > params[0]){
 						j = CS_OPEN;
 						putssQ("NVRD:");
@@ -975,6 +1055,7 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 					params[0] = 0;
 					params[1] = 0;
 					get_Dargs(1, nargs, args, params);							// parse param numerics into params[] array
+					nvc_flush(1);												// write back the VFO cache first...
 					if(px){
 						putssQ("NV descending fill...");
 						i = 0xff;
@@ -996,6 +1077,10 @@ int x_cmdfn(U8 nargs, char* args[ARG_MAX], U16* offset){
 						i = rw8_nvr((U32)params[0], 0, CS_OPENCLOSE);
 						sprintf(obuf,"NVWR: %05x: %02x",(U32)params[0], i);
 						putsQ(obuf);
+						params[1] = params[0];
+					}
+					if(((U32)params[0] < VFO_END) && ((U32)params[1] >= VFO_0)){
+						nvc_load();												// ...then re-load it if the write hit the VFO region
 					}
 					break;
 
@@ -1676,6 +1761,12 @@ char do_cmd_help(U8 cmd_id){
 			putsQ("\tSet SQU, <mid> is module ID (Ux19 = 1, UX-129 = 6)");
 			break;
 
+		case xitc:														// xit: p[0] = count, p[1] = dir
+			putsQ("XIT <count> <up> <-c> ?");
+			putsQ("\tQueue a UX-129 X/RIT pulse train, <count> = 0-15, <up> = 1 up, 0 dn.");
+			putsQ("\tDisplays pulses pending and completed trains, -c clears the count");
+			break;
+
 		case tsac:														// tsa: p[0] = mid, p[1] = ts value
 			putsQ("TSA <mid> <0-1000 KHz> ?");
 			putsQ("\tSet TSA, <mid> is module ID (Ux19 = 1, UX-129 = 6)");
@@ -1695,6 +1786,48 @@ char do_cmd_help(U8 cmd_id){
 			putsQ("\t<mode> = '4', toggle MAIN-CALL at PTT xsitions");
 			break;
 
+		case pll_swp:													// plls
+			putsQ("PLLS ?");
+			putsQ("\tSweep setpll() frames over every channel of each band (RX/TX,");
+			putsQ("\tS/+/-, lo/hi power, main/sub).  Display ns/frame and check the");
+			putsQ("\tframe CRC against the golden value.  Takes several seconds.");
+			break;
+
+		case sin_stat:													// sin: -c clears
+			putsQ("SIN <vote> <-c> ?");
+			putsQ("\tDisplay SIN ring depth, hwm, drops, framing errs, frame age,");
+			putsQ("\tglitch stats, link quality (LQ = % clean frames), and SIN event");
+			putsQ("\tqueue overruns.");
+			putsQ("\t<vote> = 0, mid-bit sample; 1, 3x majority vote");
+			putsQ("\t-c clears the stats after display");
+			break;
+
+		case sout_stat:													// sout: -c clears
+			putsQ("SOUT <-c> ?");
+			putsQ("\tDisplay SOUT bus utilization over the last second and the peak,");
+			putsQ("\tlow-value (vol/squ) deferrals and coalesced requests.");
+			putsQ("\t-c clears the peak and counts after display");
+			break;
+
+		case sout_trc:													// strc: p[0] = H, -c clears
+			putsQ("STRC <H> <-c> ?");
+			putsQ("\tDump the SOUT trace (<us> <hex word> <cause> <depth> lines),");
+			putsQ("\tcause 0-7 = SOUT request ordinal, 8 = PTT, 9 = PTT fast path,");
+			putsQ("\t10 = X/RIT, 11 = band off.  H = latency histograms (PTT: SEND");
+			putsQ("\tedge, VFO: dial step, VOL: vol knob to first frame).");
+			putsQ("\t-c clears the trace and histograms after display");
+			break;
+
+		case sin_capt:													// scap: p[0] = mode or D/R/W, -c clears buffer
+			putsQ("SCAP <0/1/2/D/R/W> <-c> ?");
+			putsQ("\tSIN capture/replay. 0 = stop capture, 1 = capture till full,");
+			putsQ("\t2 = capture continuous, D = dump buffer (<dt ms> <hex word> lines),");
+			putsQ("\tR = replay buffer thru process_SIN() (SEND edges also run the");
+			putsQ("\tPTT fast path),");
+			putsQ("\tW <dt ms> <hex word> = load a frame for replay.");
+			putsQ("\t-c clears the buffer");
+			break;
+
 		case setnvall:													// nvall: p[0] = start_bid, p[1] = stop_bid
 			putsQ("NVALL <start_mid> <stop_mid> ?");
 			putsQ("\tSave VFO(s) to NVRAM, <mid> is module ID (Ux19 = 1, UX-129 = 6)");
@@ -78,7 +78,7 @@
 #define	ONEMIN	(SEC60)
 #define	REG_WAIT_DLY 		200				// 200ms wait limit for register action
 #define RESP_SAMP 			SEC100MS		// sets resp rate
-#define	SOUT_PACE_TIME		9				// 33/4800 s for one SOUT msg
+#define	SOUT_PACE_TIME		9				// 33/4800 s for one SOUT msg (init/CLI sends only)
 #define	SIN_PACE_TIME		50				// wait a little over 2 word times (2 x 32/4800 s for one SIN word)
 #define	CLI_BUFLEN	100						// CLI buffer length
 #define	RE_BUFLEN	40						// buffer mem lengths
@@ -126,11 +126,47 @@
 #define	SSI3_BR			LCD_BAUD			// ssi3 clock rate (Hz)
 #define SSI3_CPSDVSR	(200)
 #define	SSI3_SCR		(2)					//((SYSCLK/(SSI3_BR * SSI3_CPSDVSR)) - 1)
+// 5M baud for SSI3 (NVRAM only, PD0/PD3 are switched to SSI3 while RAMCS_N is low)
+#define	NVR_BR			5000000L			// NVRAM SPI clock rate (Hz)
+#define NVR_CPSDVSR		(2)
+#define	NVR_SCR			(4)					//((SYSCLK/(NVR_BR * NVR_CPSDVSR)) - 1)
+#define	LOCK_SETTLE_US	10					// LOCK sw settling time after RAMCS_N goes high (us)
+// NVRAM software read (nvr_get()) timing, PB2 (MISO) is shared with the LOCK sw
+#define	NVR_PIN_SETTLE_US	2				// PD0/PD3 settle after an AFSEL switch (us)
+#define	NVR_MISO_SU_US		2				// MISO setup, SCK high to sample (us)
+#define	NVR_SCK_HD_US		2				// SCK low (hold) time before the next bit (us)
 
 // SIN bit time defines... assumes PS = 0 (SYSCLK/1 is used for timer)
 #define TIMER2A_PS 0
 #define	SIN_BIT_TIME		(SYSCLK/(SIO_BAUD * (TIMER2A_PS + 1)))		// 10416
 #define	SIN_HALF_BIT_TIME	(SIN_BIT_TIME/2)							// 5208
+// SIN edge capture defines... Timer2A is a 24b edge-time capture on T2CCP0 (the PS reg is the
+//	timer extension, so captured edge times are still SYSCLK/1).  Timer2B is a one-shot that marks
+//	the end of the frame window.
+#define	TIMER2A_CAP_PS		0xff										// 24b capture timer extension
+#define	SIN_TSTAMP_MASK		0x00ffffffL									// 24b capture timestamp mask
+#define	SIN_DATA_BITS		17											// SIN[30:14] are data, SIN[13:0] are stop bits
+#define	SIN_EDGE_MAX		(SIN_DATA_BITS + 8)							// max edges held for one frame (allows a few glitches)
+#define	SIN_VOTE_TIME		(SIN_BIT_TIME/4)							// 3x SIN sample spacing (samples at 1/4, 1/2, & 3/4 bit)
+#define	SIN_VOTE_DFLT		0											// IPL SIN sample mode: 0 = mid-bit, 1 = 3x majority vote
+#define	SIN_START_MIN		SIN_HALF_BIT_TIME							// min start bit width (shorter is a false start)
+#define TIMER2B_PS 3
+#define	SIN_FRAME_TIME		((SIN_BIT_TIME * (SIN_DATA_BITS + 1)) / (TIMER2B_PS + 1))	// 46872
+// SOUT sequence engine... each SOUT frame is sent as 3 x 11b SSI1 frames (start + 30b + 2 stop bits
+//	= 33b), so uDMA ch25 (encoding 0 = SSI1 TX) can stream frames back-to-back at exactly 2 stop bits
+//	of spacing.  The SSI1 EOT intr marks the end of a sequence.
+#define	SOUT_SSI_PER_FRAME	3											// SSI1 (11b) transfers per SOUT frame
+#define	SOUT_SEQ_MAX		32											// max frames in one SOUT sequence
+#define	SOUT_DMA_CH			25											// uDMA channel
+#define	SOUT_DMA_ENC		0											// channel encoding (SSI1 TX)
+// SOUT bus budget... frames started are binned over a sliding window to measure bus occupancy
+#define	SOUT_FRAME_BITS		33											// bits per SOUT frame on the wire
+#define	SOUT_BW_BINS		8											// window bins (must be a power of 2)
+#define	SOUT_BW_BINMS		125											// bin width (ms), 8 x 125 = 1 sec window
+#define	SOUT_BW_CAP			((SIO_BAUD * SOUT_BW_BINMS * SOUT_BW_BINS) / (SOUT_FRAME_BITS * 1000L))	// frames per window at 100%
+#define	SOUT_FRAME_US		((SOUT_FRAME_BITS * 1000000L) / SIO_BAUD)	// on-wire time of one SOUT frame (us)
+#define	US_TIMER_PS			((SYSCLK / 1000000L) - 1)					// WTimer5A prescale for the 1us timebase
+#define	SOUT_BW_HI			75											// util (%) above which low-value traffic yields to a retune
 
 // timer definitions
 #define TIMER1_PS 31				// prescale value for timer1
@@ -506,6 +542,7 @@ void Timer0A_ISR(void);
 void gpiob_isr(void);
 void gpioc_isr(void);
 void Timer3A_ISR(void);
+void Timer3B_ISR(void);				// PTT fast path (radio.c)
 
 //-----------------------------------------------------------------------------
 // End Of File
@@ -289,8 +289,7 @@ void process_UI(U8 cmd){
 		}
 		//**************************************
 		// process slide switches (DIM and LOCK)
-		if((GPIO_PORTD_DATA_R & RAMCS_N) == LOCK_SELECT){
-//			wait(5);														// guaranteed settling time !!! need better solution here
+		if(nvr_lock_ok()){													// PB2 is the LOCK sw (NVRAM deselected and settled)
 			i = GPIO_PORTB_DATA_R & (DIM | MISO_LOCK);						// capture DIM/LOCK switch settings
 			if(i ^ sw_stat){												// if changes..
 				if(i & DIM){
@@ -417,9 +416,8 @@ U8 process_MS(U8 mode){
 	U8	k;					// band index
 	U8	l;
 	U8	m;
-	U32	ii;
-	volatile U32	sin_a0;
 	volatile U32	sin_a1;
+	U16	ev;					// SIN event
 	U8	band_focus = mode;	// band focus of keys/dial
 	S32	sii;
 
@@ -441,7 +439,10 @@ U8 process_MS(U8 mode){
 		//**************************************
 		// process SIN changes
 		k = get_band_index(band_focus);
-		iflags |= read_sin_flags(0);									// merge with radio.c variable
+		while(get_sin_event(SEVC_UI, &ev)){
+			iflags |= sin_event_flag(ev);								// merge SIN change events
+		}
+		iflags |= read_sin_flags(0);									// merge forced updates from radio.c
 		if(iflags){
 			// got changes...
 			if(ptt_change & PTT_EDGE){
@@ -449,14 +450,11 @@ U8 process_MS(U8 mode){
 				ptt_change &= ~PTT_EDGE;
 //				read_sin_flags(SIN_SEND_F);								// clear changes flag
 			}
-			sin_a0 = fetch_sin(0);										// update data
 			// check if squelch adjust
 			if(!(xmodeq & SQU_XFLAG)){
 				if(iflags & SIN_MSRF_F){
 					// update SRF
-					ii = sin_a0 >> 23;									// isolate main and sub SRF
-					i = (U8)(ii & 0x0f);
-					msmet(i>>1, 0);										// update glass
+					msmet(get_srf(MAIN), 0);							// update glass
 					read_sin_flags(SIN_MSRF_F);							// clear changes flag
 					if(xmode[get_band_index(MAIN)] & CALL_XFLAG){
 						mmem(get_callnum(MAIN, 0));						// update call#
@@ -469,9 +467,7 @@ U8 process_MS(U8 mode){
 			if(!(xmodeq & VOL_XFLAG)){
 				if(iflags & SIN_SSRF_F){
 					// update SRF
-					ii = sin_a0 >> 19;									// isolate main and sub SRF
-					i = (U8)(ii & 0x0f);
-					ssmet(i>>1, 0);										// update glass
+					ssmet(get_srf(SUB), 0);								// update glass
 					read_sin_flags(SIN_SSRF_F);							// clear changes flag
 					if(xmode[get_band_index(SUB)] & CALL_XFLAG){
 						smem(get_callnum(SUB, 0));						// update call#
@@ -482,13 +478,13 @@ U8 process_MS(U8 mode){
 			}
 			if(iflags & (SIN_SQSM_F|SIN_SQSS_F)){						// LED updates (MRX, MTX, SRX)
 				// update RX LEDs
-				if((sin_a0 & SIN_SQSA) && !(sys_err & (NO_B_PRSNT|NO_MUX_PRSNT))){
+				if(sin_field(SEV_COSM) && !(sys_err & (NO_B_PRSNT|NO_MUX_PRSNT))){
 					GPIO_PORTC_DATA_R |= MRX_N;							// main led = on
 					scan_time(MAIN, 2);									// reset scan timer
 				}else{
 					GPIO_PORTC_DATA_R &= ~MRX_N;						// main led = off
 				}
-				if(sin_a0 & SIN_SQSB && !(sys_err & (NO_B_PRSNT|NO_SUX_PRSNT))){
+				if(sin_field(SEV_COSS) && !(sys_err & (NO_B_PRSNT|NO_SUX_PRSNT))){
 					// sub led
 					GPIO_PORTC_DATA_R |= SRX_N;							// sub led = on
 					if(scan_switch){
@@ -2017,8 +2013,8 @@ U32 process_DIAL(U8 focus){
 				do_1beep();
 			}else{
 				if(!(GPIO_PORTC_DATA_R & MRX_N) || (xmodez & MSCANM1_XFLAG)){ // main COS inactive or 1st scan
-					if(!scan_time(MAIN, 0) || (xmodez & MSCANM1_XFLAG)){
-						// process if scan timer == 0
+					if((!scan_time(MAIN, 0) && sout_admit()) || (xmodez & MSCANM1_XFLAG)){
+						// process if scan timer == 0 (and the SOUT bus budget allows a step)
 						xmodez &= ~MSCANM1_XFLAG;
 						if(!nxtscan(MAIN, 1)){
 							doscan(MAIN, 0);					// shut down scan, no mems enabled
@@ -2039,8 +2035,8 @@ U32 process_DIAL(U8 focus){
 		// sub mem scan...
 		if(xmodeq & MSCANS_XFLAG){
 			if(!(GPIO_PORTC_DATA_R & SRX_N) || (xmodez & MSCANS1_XFLAG)){					// sub COS inactive
-				if(!scan_time(SUB, 0) || (xmodez & MSCANS1_XFLAG)){
-					// process if scan timer == 0
+				if((!scan_time(SUB, 0) && sout_admit()) || (xmodez & MSCANS1_XFLAG)){
+					// process if scan timer == 0 (and the SOUT bus budget allows a step)
 					xmodez &= ~MSCANS1_XFLAG;
 					if(scan_switch){
 						scan_time(SUB, 4);							// reset scan timer after band edge (don't advance mem#)
@@ -3615,41 +3611,19 @@ U8 nxtscan(U8 focus, U8 adder){
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// get_mscan() gathers scan enable bits for all mem locations.
+// get_mscan() gathers scan enable bits for all mem locations (from the RAM
+//	scan-enable index, no NVRAM traffic).
 //	main just does main band, sub does all bands
 //-----------------------------------------------------------------------------
 void get_mscan(U8 focus){
 	U8	bid;
-	U8	j;
-	U8	k;
-	U32	mask;
 
 	if(focus == MAIN){								// process main band
 		bid = get_band_index(focus);
-		mask = 0x20000000L;							// set start at mem#29
-		mscan[bid] = 0;
-		j = MAX_MEM-1;
-		do{
-			k = get_scanen(bid, j);					// k is true if scan enabled
-			if(k){
-				mscan[bid] |= mask;
-			}
-			j--;
-			mask >>= 1;
-		}while(mask);
+		mscan[bid] = get_scanix(bid);
 	}else{											// process all bands
 		for(bid=0; bid<ID1200; bid++){
-			mscan[bid] = 0;
-			mask = 0x20000000L;						// set start at mem#30
-			j = MAX_MEM-1;
-			do{
-				k = get_scanen(bid, j);				// k is true if scan enabled
-				if(k){
-					mscan[bid] |= mask;
-				}
-				j--;
-				mask >>= 1;
-			}while(mask);
+			mscan[bid] = get_scanix(bid);
 		}
 	}
 	return;
@@ -288,16 +288,19 @@
 //  Interrupt Resource Map:
 //	*	Timer0A			PF0:		ISR SW gated 1KHz pulse output to drive piezo spkr (uses PWM and ISR to generate and gate off the beep)
 //	*	Timer1A			--			ISR serial pacing timer
-//	*	Timer1B			--			ISR bit-bang SSI bit-rate timer
-//	*	SSI1			PF1:		ASO async output (4800 baud, 1 start, 30 bit + 1 stop (plus an implied stop bit)
-//		Timer2A			PF4:		ISR ASI async input (4800 baud, 1 start, ... )
-//		GPIO FE			PF4:		ISR (detects ASI start bit, starts Timer2A)
+//	*	Timer1B			--			ISR bit-bang SSI bit-rate timer (LCD only)
+//	*	SSI1			PF1:		ISR ASO async output (4800 baud, 1 start, 30 bit + 2 stop), uDMA ch25 feeds the TX FIFO, EOT intr ends a sequence
+//		Timer2A			PF4:		ISR ASI async input (4800 baud, 1 start, ... ) T2CCP0 edge-time capture, timestamps each SIN edge
+//		Timer2B			--			ISR ASI frame window (one-shot started by the start edge, rebuilds the SIN word from the edge times)
 //	*	UART0 			PA[1:0]:	ISR(RX) Bluetooth serial port
 //		UART1			PB[1:0]:	ISR(RX) PGM command port (TTL to external RS232 to PC)
 //	*	M1PWM (6&7)		PF2, PF3:	LED PWMs (PF3 = backlight, PF2 = all other LEDs)
 //		GPIO edge		PC[6:5]:	ISR Main dial (up/dn type), edge intrpts to count encoder pulses (debounce in Timer3A ISR)
 //		bbSSI			PD0, PD3:	LCD command/data comms.  Uses PD1, PD6, PE0, PE1, & PB7 (SSI3 can no longer be used due to GPIO constraints for MISO)
+//		SSI3			PD0, PD3:	NVRAM writes at 5 MHz (pins switched from bbSSI while RAMCS_N is low).  MISO (PB2) has no SSI Rx, NVRAM reads are shifted in by SW
 //	*	Timer3A			--			ISR Application timers & keyscan
+//	*	Timer3B			--			ISR PTT fast path (no timer, SW triggered by Timer2B on a SIN SEND edge, sends the cached PTT sequence)
+//		WTimer5A		--			1us free-running timebase (no intr) for the SOUT trace and latency histograms
 //		ADC0			PD2:		Ambient light sensor
 //
 //		QEI1			(future) @PC[6:5]: Main dial
@@ -530,7 +533,7 @@ int main(void){
         set_pwm(6, 10);
     	process_IO(PROC_INIT);							// init process_io
     	btredir = 0;
-    	sprintf(buf,"NVsrt %0x, NVend %0x", NVRAM_BASE, MEM_END);
+    	sprintf(buf,"NVsrt %0x, NVend %0x (live %0x)", NVRAM_BASE, NVMIG_END, SCANIX_END);
     	putsQ(buf);
     	// GPIO init
     	//...
@@ -818,6 +821,10 @@ char process_IO(U8 flag){
 	}
 	process_UI(flag);									// Process changes to the user interface state
 	process_CMD(flag);									// process CMD_FN state (primarily, the MFmic key-entry state machine)
+	if(flag != PROC_INIT){
+		nvc_flush(0);									// write back the VFO NVRAM cache when due
+		mcache_prefetch();								// prefetch scan mems
+	}
 //	process_CCMD(flag);									// process CCMD inputs
 	return swcmd;
 }
@@ -0,0 +1,226 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: pll_frm.c
+ *
+ *  Module:    Control
+ *
+ *  Summary:
+ *  Band descriptor table and SOUT PLL frame builder for the IC-900
+ *  band modules.  This file has no hardware dependencies so that it
+ *  can also be built on a host (see host_test/pll_sweep_gen.c).
+ *
+ *******************************************************************/
+
+#include "typedef.h"
+#include "init.h"						// App-specific SFR Definitions
+#include "sio.h"
+#include "radio.h"
+#include "uxpll.h"
+
+// band descriptor table (index = module ID - 1)
+const struct band_desc_struct band_desc[ID1200] = {
+//	 MHz range		ham band		RX base			PLL base	TX offset			init frame		chan	format
+	{ 20,	39,		20,		40,		BASE_RX_10M,	PLL_10M,	-BASE_TX_10M,		INIT_PLL_10M,	5,		PLLF_SHL|PLLF_INIT },	// ID10M
+	{ 40,	60,		50,		54,		BASE_RX_6M,		PLL_6M,		-BASE_TX_6M,		INIT_PLL_6M,	5,		PLLF_SHL|PLLF_INIT },	// ID6M
+	{ 120,	170,	144,	148,	BASE_RX_2M,		PLL_2M,		BASE_TX_2M,			0,				5,		PLLF_INS },				// ID2M
+	{ 220,	225,	220,	226,	BASE_RX_220,	PLL_220,	BASE_TX_220,		0,				5,		PLLF_INS },				// ID220
+	{ 400,	455,	400,	456,	BASE_RX_440,	PLL_440,	BASE_TX_440,		0,				5,		0 },					// ID440
+	{ 1200,	1320,	1200,	1321,	BASE_RX_1200,	PLL_1200,	BASE_TX_1200,		INIT_PLL_1200,	10,		PLLF_INS|PLLF_UX129 }	// ID1200
+};
+// UX-129 post-init frames (sent with PTT proto bits after every N-frame)
+const U32 ux129_post[] = { INIT_PLL_1201, INIT_PLL_1202, INIT_PLL_1203 };
+// 4-bit reversal LUT (UX-129 N-frame is sent lsb first)
+const U8 rev4[16] = { 0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe, 0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf };
+
+//-----------------------------------------------------------------------------
+// pll_build() builds the SOUT frame sequence for a VFO (vfo/offs in KHz, dplx is the
+//	duplex/power flags) with no side effects.  otx points to the main band "PTT
+//	already on" state, trptr receives the RX/TX frequency (KHz).  Returns a pointer
+//	past the end semaphore.
+//-----------------------------------------------------------------------------
+U32* pll_build(U32 vfo, U16 offs, U8 dplx, U32* plldata, U8 is_tx, U8 is_main, U8* otx, U32* trptr){
+    U8	i = 0;			// pll array index
+    U8	band_idr;		// temps
+    U32	ux_noptt;
+    U32	ux_ptt;
+    U32	pll;
+    U32	ii;
+    U32	tt;
+    U32	trfrq;			// rx/tx frequency (KHz)
+    U32	*	pllptr = plldata;
+    const struct band_desc_struct* bdp;
+/*
+#define SOUT_MAIN	0x04000000L
+#define SOUT_SUB	0x02000000L
+#define SOUT_PON	0x01000000L
+#define SOUT_LOHI	0x00800000L
+#define SOUT_BAND	0x00400000L
+#define SOUT_PTT	0x00200000L	// band unit PTT
+*/
+
+    band_idr = get_modulid(vfo / 1000L);				// use vfo frequency to determine band ID
+    ux_noptt = band_idr << 27;							// align band ID in SOUT proto word
+    if(is_main){
+    	ux_noptt |= SOUT_MAIN | SOUT_PON;				// set module pre-amble bits (main)
+    }else{
+    	ux_noptt |= SOUT_SUB | SOUT_PON;				// .. (sub)
+    }
+    if(dplx & LOHI_F){
+    	ux_noptt |= SOUT_LOHI;							// set RF power level
+    }
+    ux_ptt = ux_noptt | SOUT_PTT;						// set PTT in is_tx proto word
+    if(is_tx){
+    	switch(dplx & (DPLX_P|DPLX_M)){					// calculate TX frequency (if is_tx)
+    	default:
+    	case DPLX_S:
+    		trfrq = vfo;
+    		break;
+
+    	case DPLX_M:
+    		trfrq = vfo - (U32)offs;
+    		break;
+
+    	case DPLX_P:
+    		trfrq = vfo + (U32)offs;
+    		break;
+    	}
+    }else{
+    	trfrq = vfo;									// no TX, no calc needed
+    }
+	// !!!
+/*	char tgbuf[20];
+	sprintf(tgbuf,"frq: %d",trfrq); //!!!
+	putsQ(tgbuf);
+*/
+    //
+    // use calculated band_id to index the band descriptor
+    //	convert VFO freq to chanelized value for PLL formatting
+    if(((band_idr & 0x0f) == BANDOFF) || ((band_idr & 0x0f) > ID1200)){
+        pllptr[0] = 0xffffffff;							// error trap, set empty PLL update string
+        *trptr = trfrq;
+        return &pllptr[1];
+    }
+    bdp = &band_desc[(band_idr & 0x0f) - 1];
+    pll = (trfrq - bdp->base_rx) / (U32)bdp->chan;		// convert to 5/10KHz chan
+    pll += bdp->pll_base;								// add base PLL bitmap
+    if (is_tx) {
+        pll += (U32)bdp->tx_offs;						// add (signed) tx offset
+    }
+    if(bdp->fmt & PLLF_SHL){
+        pll <<= 1;										// align bitmap (only for 10M and 6M)
+    }
+    if(bdp->fmt & PLLF_INS){
+        // insert a "0" into bit 6 ==> [...ponmlkjihg0fedcba]
+        pll = ((pll << 1) & 0x3ff80L) | (pll & 0x003fL);
+    }
+    if(bdp->fmt & PLLF_UX129){
+        // add "code" bits for N-frame
+        pll |= PLL_1200_N;
+        // bit reverse (20 bits, a nibble at a time)... tt will contain the new, bit-reversed PLL frame
+        tt = ((U32)rev4[pll & 0x0f] << 16) | ((U32)rev4[(pll >> 4) & 0x0f] << 12) | ((U32)rev4[(pll >> 8) & 0x0f] << 8) |
+             ((U32)rev4[(pll >> 12) & 0x0f] << 4) | (U32)rev4[(pll >> 16) & 0x0f];
+        pllptr[i++] = ux_noptt | bdp->init;				// init frame
+        pllptr[i++] = ux_noptt | tt;					// store PLL plus bit length
+        if(is_tx){
+            pllptr[i++] = ux_ptt | tt;					// store PLL plus PTT
+        }
+        for(ii=0; ii<(sizeof(ux129_post)/sizeof(U32)); ii++){
+            pllptr[i++] = ux_ptt | ux129_post[ii];		// post-init frames
+        }
+    }else{
+        if(bdp->fmt & PLLF_INIT){
+            if(*otx){
+            	pllptr[i++] = ux_ptt | bdp->init;		// store init frame w/ ptt on
+            }else{
+            	pllptr[i++] = ux_noptt | bdp->init;		// store init frame
+            }
+        }
+        if(is_main){
+            if(!*otx){
+            	pllptr[i++] = ux_noptt | pll;			// on 1st pass, don't turn on PTT
+            	*otx = is_tx;
+            }
+        }else{
+        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
+        }
+        if(is_tx){
+            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
+        }
+    }
+    pllptr[i] = 0xffffffff;								// set end of PLL update string
+    *trptr = trfrq;
+    return &pllptr[i+1];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// get_modulid() calculates band id (1-6) from input freq (MHz)
+//	and set wide-band bit if outside the ham RX limits
+//-----------------------------------------------------------------------------
+U8 get_modulid(U32 freqMM){
+    U8	j;
+    U8	i = BANDOFF;
+
+    for(j=0; j<ID1200; j++){
+        if((freqMM >= band_desc[j].mhz_lo) && (freqMM <= band_desc[j].mhz_hi)){
+            i = j + 1;									// module ID
+            if((freqMM < band_desc[j].nb_lo) || (freqMM >= band_desc[j].nb_hi)){
+                i |= (BNDID_WBIF >> BND_SHIFT);			// enable wide band RX (BAND = 1)
+            }
+            break;
+        }
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+// pll_sweep_pass() runs pll_build() over every channel of each band's module range
+//	(every frequency that get_modulid() maps to the band, including the wide-band RX
+//	channels outside the ham band), RX and TX (S/+/-), low and high power, main and sub.  If crcp != 0, the frame
+//	stream (and get_modulid() over 0 - 1999 MHz) is folded into *crcp.  If fn != 0, it
+//	is called with each frame sequence (band index, frequency (KHz), mode k, frames,
+//	frame count) so that a host harness can locate a change.  Returns the number of
+//	SOUT frames built.
+//-----------------------------------------------------------------------------
+U32 pll_sweep_pass(U16* crcp, void (*fn)(U8 bid, U32 f, U8 k, U32* fptr, U8 len)){
+	U8	j;
+	U8	k;
+	U8	otx;
+	U8	dplx;
+	U32	f;
+	U32	n = 0;
+	U32	trfrq;
+	U32	buf[PLLC_LEN];
+	U32*	eptr;
+	U32*	p;
+	const U16 swp_offs[] = { 100, 1000, 600, 1600, 5000, 12000 };	// TX offset per band (KHz)
+
+	for(j=0; j<ID1200; j++){
+		for(f=(U32)band_desc[j].mhz_lo * 1000L; f<((U32)band_desc[j].mhz_hi + 1) * 1000L; f+=band_desc[j].chan){
+			// k[0] = main, k[1] = low power, k[3:2] = 0: RX, 1: TX simplex, 2: TX plus, 3: TX minus
+			for(k=0; k<16; k++){
+				dplx = (k >> 2) ? ((k >> 2) - 1) : DPLX_S;
+				if(k & 0x02) dplx |= LOHI_F;
+				otx = 0;
+				eptr = pll_build(f, swp_offs[j], dplx, buf, (k >> 2) ? 1 : 0, k & 0x01, &otx, &trfrq);
+				n += (U32)(eptr - buf) - 1;					// don't count end semaphore
+				if(fn) (*fn)(j, f, k, buf, (U8)(eptr - buf - 1));
+				if(crcp){
+					for(p=buf; p<eptr; p++){
+						*crcp = calcrc((U8)(*p), *crcp);		// crc frames, lsb first
+						*crcp = calcrc((U8)(*p >> 8), *crcp);
+						*crcp = calcrc((U8)(*p >> 16), *crcp);
+						*crcp = calcrc((U8)(*p >> 24), *crcp);
+					}
+				}
+			}
+		}
+	}
+	if(crcp){
+		for(f=0; f<2000; f++){
+			*crcp = calcrc(get_modulid(f), *crcp);
+		}
+	}
+	return n;
+}
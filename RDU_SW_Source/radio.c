@@ -58,13 +58,30 @@
 // local declarations
 //-----------------------------------------------------------------------------
 
-U32	sin_addr0;							// holding registers for SIN data (addr 1 and 0)
-U32	sin_addr1;
-U32	sin_flags;							// bitmapped activity flags that signal changed data
-										// addr1 and 0 are muxed into a single 32 bit flag (only 16 bits of data are ever transferred)
-U8	sout_flags;							// signal for SOUT changes
+U32	sin_flags;							// bitmapped forced-update flags (update_radio_all()) and SIN timeout
+										// SIN data changes are posted to the SIN event queue (sin_evq[])
+U8	sout_flags;							// signal for SOUT changes (pending request bitmap, post with sout_post())
+// SOUT request queue: one slot per SOUT_xxx_N resource.  A new request for a resource that is
+//	already pending coalesces into it (the message is built from current state when it is served,
+//	so the newest data goes out).  sout_next() serves by priority, then by age; a request that has
+//	waited SOUT_AGE_MAX services is promoted so a dial spin can't starve vol/squ/tone.
+const U8 sout_prio[8] = {
+	2,									// SOUT_TONE_N
+	3,									// SOUT_MSQU_N
+	3,									// SOUT_SSQU_N
+	3,									// SOUT_MVOL_N
+	3,									// SOUT_SVOL_N
+	1,									// SOUT_VUPD_N (NVRAM push)
+	4,									// SOUT_VFOS_N
+	5									// SOUT_VFOM_N
+};
+U8	sout_qstamp[8];						// sout_served count when each request was posted
+U16	sout_bwdef;							// low-value SOUT traffic deferrals (bus budget)
+U8	sout_served;						// requests served (free-running)
+U16	sout_coal;							// coalesced request count
 U8	ux_present_flags;					// bitmapped "present" (AKA, "installed") flags.
 U32	ptt_mem;							// PTT memory
+
 // **************************************************************
 // these data structures are mirrored in a SW shadow NVRAM (HIB RAM)
 //	each band module has its own cluster of data for frq, offset, etc...
@@ -114,6 +131,7 @@ U8	bandoff_s;
 
 U32	vfot;								// temp vfo used for calculations and TX frequency
 U32	vfotr;								// tr vfo
+U8	old_tx;								// main band PTT is on (setpll() sequencing)
 U32	mhz_step;							// mhz digit add value - tracks the digit index in the thumbwheel digit adjust mode
 U8	mute_band;							// flags to control audio mute function for main/sub (mirror of lcd.c mute_mode)
 
@@ -132,13 +150,61 @@ U32	offs_ulim[] = { 13000L, 15000L, 40000L, 13000L, 50000L, 900000L };
 U32 mem_band[] = { ID10M_MEM, ID6M_MEM, ID2M_MEM, ID220_MEM, ID440_MEM, ID1200_MEM };
 //U32 mem_band[1] = { ID10M_MEM };
 // mem name strings
-char memname[NUM_VFOS][MEM_NAME_LEN];
+char memname[NUM_VFOS][MEM_NAME_LEN+1];
+U16	mname_ok;							// memname[] is loaded (bit n = vfo n)
+U8	mname_mem[NUM_VFOS];				// mem# of the name to load into memname[]
+// VFO NVRAM write-back cache
+U8	nvc_img[NVC_LEN];					// image of VFO_0..VFO_END
+U8	nvc_shd[NVC_LEN];					// shadow: image as last written to NVRAM
+U16	nvc_dirty;							// dirty records (bit n = VFO n, NVC_TRL = trailer)
+U32	nvc_t0;								// time the image first went dirty (ms)
+U32	nvc_tl;								// time of the last write to the image (ms)
+U32	scanix[ID1200];						// mem scan-enable index (bit n = mem n scan enabled)
+struct mcache_struct mcache[MCACHE_LEN];	// decoded mem record cache
+U8	mcache_nxt;							// next mcache entry to replace
 
 // **************************************************************
 
-#define	PLL_BUF_MAX	14
+#define	PLL_BUF_MAX	18					// fits a full burst (main + sub VFO, vol/squ, tone)
+#define	PLL_PTR_SEQ	0xfe				// pll_ptr value while the SOUT sequence engine is sending
 U32	pll_buf[PLL_BUF_MAX];				// PLL data buffer
-U8	pll_ptr;							// pll_buf index
+volatile U8	pll_ptr;					// pll_buf index
+U32	so_seq[SOUT_SEQ_MAX];				// SOUT sequence (pll_buf with X/RIT pulses expanded)
+// main band PTT frame cache: the RX and TX sequences for the main band are rebuilt whenever the
+//	band, VFO, offset, or duplex/power setting changes, so a PTT edge only has to copy a buffer.
+U32	pttc_rx[PLL_BUF_MAX];				// RX sequence (TX->RX edge)
+U32	pttc_tx[PLL_BUF_MAX];				// TX sequence (RX->TX edge)
+U32	pttc_txfrq;							// vfotr for the TX sequence
+U8	pttc_otx;							// old_tx after the TX sequence
+U8	pttc_bid;							// cache key: band ID (0xff = empty)
+U32	pttc_vfo;							// cache key: vfo
+U16	pttc_offs;							// cache key: offset
+U8	pttc_dplx;							// cache key: duplex/power flags
+// PTT fast path: Timer3B_ISR() (software triggered by the SIN ISR on a SEND edge) sends the cached
+//	sequence ahead of process_SOUT(), which then only does the PTT housekeeping.
+volatile U8	ptt_fast;					// PTT state sent by Timer3B_ISR() | PTTF_SENT (0 = none)
+volatile U8	ptt_fpend;					// fast path deferred (SOUT engine was busy)
+// UX-129 X/RIT pulse sequencer: the up/dn counter pulse train is sent in XIT_CHUNK pulse sequences
+//	between the other SOUT traffic, so PTT and retunes never wait on a whole train.
+U32	xit_seq[XIT_CHUNK * 2];				// pulse frames for the chunk in flight
+U8	xit_rem;							// pulses not yet sent
+U8	xit_dir;							// UX_XIT_UP if counting up
+volatile U8	xit_busy;					// chunk in flight
+U16	xit_done;							// completed pulse trains
+struct pllc_struct pllc[2];				// setpll() frame cache (index = MAIN/SUB)
+U8	sout_mutecf;						// mute confirm semaphore was in the last sequence
+U8	pll_cause[PLL_BUF_MAX];				// SOUT trace cause of each pll_buf frame
+U8	so_cause[SOUT_SEQ_MAX];				// SOUT trace cause of each so_seq frame
+// SOUT trace ring and latency histograms.  written from the main loop and the PTT fast path,
+//	so the ring and the histograms are updated with intrs masked (the entry PRIMASK is restored).
+#define	SOTR_LOCK(pm)	pm = int_lock()
+#define	SOTR_UNLOCK(pm)	int_unlock(pm)
+struct sotr_struct sotr[SOTR_MAX];
+U16	sotr_w;								// trace write count (free-running)
+U32	lat_t0[LAT_NUM];					// latency start time (us)
+U8	lat_arm[LAT_NUM];					// latency start is armed
+U16	lat_hist[LAT_NUM][LAT_BINS];		// latency histograms
+U32	lat_max[LAT_NUM];					// max latency (us)
 
 // reset units
 #define	SO_INIT_LENA	2
@@ -168,6 +234,14 @@ U32	so_initc[] = {
 // local Fn declarations
 
 U8 get_busy(void);
+void lat_hit(U8 lclass, U32 t);
+void nvc_span(U8 s, U8 e);
+void scanix_build(void);
+void scanix_save(void);
+U8 mcache_find(U8 bid, U8 memnum);
+U8 mcache_load(U8 bid, U8 memnum);
+char* mname_get(U8 band);
+void nvsn_wr(U16 sn);
 
 //-----------------------------------------------------------------------------
 // ***** START OF CODE *****
@@ -184,6 +258,8 @@ void init_radio(void){
 	U8	usnbuf[16];		// User SN buffer
 //	char	ibuf[25];	// sprintf/putsQ debug patch !!!
 
+	mcache_inval(MCACHE_ALL, 0);						// empty the mem cache
+	mname_ok = 0xffff;									// no mem names to load
 	wait(50);
 	// send init array 1 (reset)
 	for(i=0; i<SO_INIT_LENA; i++){						// do base module reset
@@ -197,6 +273,7 @@ void init_radio(void){
 	putsQ("UXsch:");
 	for(i=0, j=0x01; i<(SO_INIT_LENB-1); i++, j<<=1){
 		send_so(so_initb[i]);							// send a query message to each possible module
+		sin_refresh();									// make sure the busy response is queued even if it repeats
 		set_wait(20);
 		do{
 			k = get_busy();								// clean out input buffer after module select
@@ -233,15 +310,15 @@ void init_radio(void){
 	ii = (U16)usnbuf[14];
 	ii |= ((U16)usnbuf[15]) << 8;
 	if(ii != nvram_sn()){
-		// if version SN incorrect, invalidate NVRAM
-		// future versions may call a "fixit" fn that updates an
-		// out-of-version NVRAM without deleting the existing config.
-		k = FALSE;
-		putsQ("USNfail");								// display error msg to console
+		// if version SN incorrect, update an older layout in place (nvram_fix()),
+		// else invalidate NVRAM
+		if(!k || !nvram_fix(ii)){
+			k = FALSE;
+			putsQ("USNfail");							// display error msg to console
+		}
 	}
 	if(!k){
 		// Validation fail, stored VFO data corrupt: re-initialize...
-		// (nvram_fix(ii) is the function we need here.  Maybe someday...)
 		putsQ("Initializing VFOS...");					// display status msg to console
 
 		for(i=ID10M_IDX; i<NUM_VFOS; i++){
@@ -292,6 +369,7 @@ void init_radio(void){
 		ux129_rit = 0;
 		clear_xmode();									// init xmode to no mem/call
 		push_vfo();										// push new data vfo to nvram (hib)
+		nvc_flush(1);
 		// init mems
 		putsQ("Initializing MEMS...");					// display status msg to console
 		// copy default VFOs to memory space
@@ -300,6 +378,7 @@ void init_radio(void){
 				write_mem(MAIN, i);
 			}
 		}
+		scanix_build();									// re-index the new mems
 		bandid_m = BAND_ERROR;							// default to error, figure out assignment below...
 		bandid_s = BAND_ERROR;
 		ii = nvram_sn();
@@ -314,6 +393,8 @@ void init_radio(void){
 //		vfo_p[ID440_IDX].ctcss = 0x10;					// PL setting = 114.8
 //		get_lohi(MAIN, 1);
 //		get_lohi(SUB, 1);
+	}else{
+		scanix_load();									// load the mem scan-enable index
 	}
 	putsQ("Validate selected module...");				// display status msg to console
 	// double-check band-ids for validity against installed hardware
@@ -406,9 +487,8 @@ void init_radio(void){
 //-----------------------------------------------------------------------------
 void process_SIN(U8 cmd){
 	U32	sin_data;
-	U32	ii;				// temp
 	U32 tt;
-	char	dbuf[35];	// !!! debug buff
+	char	dbuf[60];	// !!! debug buff
 	static U32 lerr;
 
 	if(cmd == PROC_INIT){								// initial program load (reset) branch
@@ -417,33 +497,18 @@ void process_SIN(U8 cmd){
 		sin_addr1 = 0;
 		sin_flags = 0;
 		lerr = 10L;
+		init_sin_event();								// reset SIN event queue
 		init_radio();									// init radio and data structures
 		ptt_mem = 0x10L;
+		post_sin_event(SEV_PTT, 0);						// force initial PTT update (RX)
 		xmodez_init();
 		return;
 	}													// normal (run) branch
 	if(got_sin()){
 		sin_data = get_sin();							// get'n check for SIN data
-		if((sin_data & SIN_STOP) == SIN_STOP){			// validate extended "stop" bits
+		if(sin_word(sin_data)){							// validate extended "stop" bits, post change events
 			clr_sys_err(NO_B_PRSNT);					// clear LOS error
 			sin_flags &= ~SIN_SINACTO_F;				// clear timeout error
-			if(sin_data & SIN_ADDR){					// process addr == 1 data
-				// ADDR 1
-				if(sin_data != sin_addr1){				// if data is new (different == new)
-					// process new addr1 data ... calculate change flags
-					ii = ((sin_data ^ sin_addr1) & SIN1_DATA) & 0xffff0000L;
-					sin_flags |= ii;
-					sin_addr1 = sin_data;				// store new data
-				}
-			}else{
-				// process ADDR == 0 data
-				if(sin_data != sin_addr0){				// if data is new (different == new)
-					// process new addr0 data ... calculate change flags
-					ii = (((sin_data ^ sin_addr0) & SIN0_DATA) >> 16) & 0x0000ffffL;
-					sin_flags |= ii;
-					sin_addr0 = sin_data;
-				}
-			}
 		}else{
 			// no (valid) data
 			sprintf(dbuf,"0err = %d, data = 0x%08x, free = %d", get_error(), sin_data, get_free());
@@ -460,7 +525,7 @@ void process_SIN(U8 cmd){
 	tt = get_error();
 	if(tt != lerr){
 		lerr = tt;
-		sprintf(dbuf,"ORerr = %d, free = %d", tt, get_free());
+		sprintf(dbuf,"ORerr = %d, hwm = %d, free = %d", tt, get_sin_hwm(), get_free());
 		putsQ(dbuf);
 	}
 //	print_ptr(); //!!!
@@ -470,31 +535,47 @@ void process_SIN(U8 cmd){
 //-----------------------------------------------------------------------------
 // process_SOUT() processes SOUT buffer
 //	input signals:
-//		sin_flags (PTT, srf, cos)
+//		SIN events (PTT)
 //		sout_flags (vfo freq, T, SQU/D, VOLU/D)
 //		uses a U32 buffer array to sequence SOUT data to be sent
+//		all pending sout_flags work is planned into one burst (priority order, main before sub
+//		at equal age) and handed off to the SOUT sequence engine (send_so_seq()) on the same pass
 //	returns pll_ptr .. if == 0xff, send is idle.
 //-----------------------------------------------------------------------------
 U8 process_SOUT(U8 cmd){
 			U8	i;				// temp
 			U8	j;
 			U8	k = 0;
-	static	U8	xit_count;		// used to mechanize UX-129 XIT/RIT adjustment sequences
-	static	U8	xit_dir;
 	static	U8	last_mvol;
 	static	U8	last_msqu;
 	static	U8	last_svol;
 	static	U8	last_ssqu;
 			U32 ii;
 			U32* pptr;			// pointer into SOUT buffer
+			U16	ev;				// SIN event
+			U8	p0;				// pll_ptr at start of a sequence
+			U8	sv;				// VFOs to save after the burst is handed off
+			U8	mcf;			// burst includes a vol update (confirm mute)
+			U8	lv;				// low-value signals held off by the bus budget
+			U8	c;				// SOUT trace cause of the item being planned
+			U8	xn;				// X/RIT words in the burst being handed off
+			U8	xw[SOUT_SEQ_MAX];	// .. (started once the burst has the engine)
 //			char dgbuf[30];		// !!! debug sprintf/putsQ buffer
 
 	// IPL (reset) init of local statics
 	if(cmd == PROC_INIT){
 		pll_ptr = 0xff;								// set index to "idle" state
-		sout_time(0);								// initialize timer and statics
-		xit_count = 0;
-		xit_dir = 0;
+		sout_mutecf = 0;							// initialize statics
+		pttc_bid = 0xff;							// empty PTT frame cache
+		pllc[MAIN].bid = 0xff;						// empty setpll() frame cache
+		pllc[SUB].bid = 0xff;
+		ptt_fast = 0;								// init PTT fast path
+		xit_rem = 0;								// init X/RIT sequencer
+		xit_busy = 0;
+		ptt_fpend = 0;
+		clr_sout_trace();							// init SOUT trace
+		NVIC_PRI9_R = (NVIC_PRI9_R & ~NVIC_PRI9_INT36_M) | (PTTF_IPRI << NVIC_PRI9_INT36_S);
+		NVIC_EN1_R = NVIC_EN1_TIMER3B;				// enable timer3B (SW triggered) intr in the NVIC_EN regs
 		last_mvol = 0xff;							// force initial update of vol/squ
 		last_msqu = 0xff;
 		last_svol = 0xff;
@@ -504,10 +585,16 @@ U8 process_SOUT(U8 cmd){
 		return 0;
 	}
 	// if not IPL, run normal process...
+	sv = 0;
 	if(pll_ptr == 0xff){
 		// no data is being sent branch ...
+		if(sout_mutecf){
+			mute_band |= 0x80;														// last sequence confirmed mute
+			sout_mutecf = 0;
+		}
 		j = 0;
 		if(bandoff_m){																// turn-off band module flag trap, main
+			pll_cause[j] = SOTR_BOFF;
 			pll_buf[j++] = (U32)bandoff_m << 27;
 			pll_ptr = 0;
 			bandoff_m = 0;															// clear signal flag
@@ -515,6 +602,7 @@ U8 process_SOUT(U8 cmd){
 			k = 0xff;																// processing...
 		}
 		if(bandoff_s){																// turn-off band module flag trap, main
+			pll_cause[j] = SOTR_BOFF;
 			pll_buf[j++] = (U32)bandoff_s << 27;
 			pll_ptr = 0;
 			bandoff_s = 0;															// clear signal flag
@@ -522,7 +610,10 @@ U8 process_SOUT(U8 cmd){
 			k = 0xff;																// processing...
 		}
 		if(!j){
-			ii = sin_addr1 & SIN_SEND;
+			ii = ptt_mem;
+			while(get_sin_event(SEVC_SOUT, &ev)){
+				if(SEV_ID(ev) == SEV_PTT) ii = SEV_VAL(ev);							// keep the latest PTT state
+			}
 			if(ii != ptt_mem) {														// PTT change detected
 				ptt_mem = ii;														// save change
 				if(ii){
@@ -537,9 +628,20 @@ U8 process_SOUT(U8 cmd){
 				}
 				set_ptt(i);															// transfer to lcd.c
 				amtx(i^1);															// update TX LED
-				setpll(bandid_m, pll_buf, i, MAIN);									// PTT only drives MAIN band, set the module for TX
+				if((ptt_fast == (i | PTTF_SENT)) && ptt_cache_get(i, 0)){			// if Timer3B_ISR() already sent this edge,
+					ptt_fast = 0;													// .. just update the PTT state
+				}else{
+					ptt_fast = 0;
+					if(!ptt_cache_get(i, pll_buf)){									// use the precomputed sequence if it is current..
+						setpll(bandid_m, pll_buf, i, MAIN);							// ..else build it. PTT only drives MAIN band, set the module for TX
+					}
+					for(j=0; j<PLL_BUF_MAX; j++){
+						pll_cause[j] = SOTR_PTT;
+					}
+					lat_mark(LAT_PTT, get_sin_sendus());
+					pll_ptr = 0;													// enable data send
+				}
 				set_vfo_display(VMODE_ISTX | MAIN);
-				pll_ptr = 0;														// enable data send
 //					sprintf(dgbuf,"sinf: %08x",sin_flags); //!!!
 //					putsQ(dgbuf);
 				sin_flags &= ~SIN_SEND_F;											// clear the signal
@@ -550,148 +652,514 @@ U8 process_SOUT(U8 cmd){
 			}else{
 				// process sout signals
 				if(sout_flags){														// if not zero, there are (bit-mapped) signals to process
+					// plan one burst: take the pending signals in priority order and append their
+					//	frames to pll_buf until nothing is eligible or the next item might not fit
 					pptr = pll_buf;													// preset sout buffer pointer
-					// get an ordinal value for the highest priority signal
-					if(mute_time(0)){
-						i = get_bit(sout_flags & ~(SOUT_MVOL_F|SOUT_SVOL_F));		// if mute delay, mask off vol flags
+					mcf = 0;
+					if(sout_admit()){
+						lv = 0;
 					}else{
-						i = get_bit(sout_flags);
+						lv = SOUT_MVOL_F|SOUT_SVOL_F|SOUT_MSQU_F|SOUT_SSQU_F;		// vol/squ steps wait (and coalesce) behind the retune
+						if(sout_flags & lv) sout_bwdef++;
 					}
-					switch(i){														// this will mechanize the various updates to process in order without collision
-					case SOUT_VFOM_N:
-						if(sin_addr1 & SIN_SEND) i = 1;								// get current state of PTT
-						else i = 0;
-						pptr = setpll(bandid_m, pll_buf, i, MAIN);					// update main pll
-						pll_ptr = 0;
-						sout_flags &= ~SOUT_VFOM_F;									// clear the signal
-						set_vfo_display(MAIN);										// send disp update signal
-						save_vfo(bandid_m);											// save affected VFO
-						break;
-
-					case SOUT_VFOS_N:
-						setpll(bandid_s, pptr, 0, SUB);								// update main pll
-						pll_ptr = 0;
-						sout_flags &= ~SOUT_VFOS_F;
-						set_vfo_display(SUB_D);										// send disp update signal
-						save_vfo(bandid_s);											// save affected VFO
-						break;
-
-					case SOUT_MVOL_N:												// process VOL/SQU triggers...
-						if((mute_band & MS_MUTE) || (bandid_m > ID1200_IDX)){
-							i = 0;													// 0 if muted
+					do{
+						if(mute_time(0)){
+							i = sout_next(sout_flags & ~(lv|SOUT_MVOL_F|SOUT_SVOL_F));	// if mute delay, mask off vol flags
 						}else{
-							i = vol_m;
-						}
-						if(i != last_mvol){
-							last_mvol = i;
-							pll_buf[0] = atten_calc(i) | ATTEN_MAIN | VOL_ADDR;
-							pll_ptr = 0;
-							pll_buf[1] = 0xfffffffeL;								// set to confirm mute
-						}
-						sout_flags &= ~SOUT_MVOL_F;									// clear signal flag
-						break;
-
-					case SOUT_SVOL_N:
-						if((mute_band & SUB_MUTE) || (bandid_s > ID1200_IDX)){
-							i = 0;
-						}else{
-							i = vol_s;
-						}
-						if(i != last_svol){
-							last_svol = i;
-							pll_buf[0] = atten_calc(i) | ATTEN_SUB | VOL_ADDR;
-							pll_ptr = 0;
-							pll_buf[1] = 0xfffffffeL;								// set to confirm mute
+							i = sout_next(sout_flags & ~lv);
 						}
-						sout_flags &= ~SOUT_SVOL_F;									// clear signal flag
-						break;
-
-					case SOUT_MSQU_N:
-						i = vfo_p[bandid_m].sq;
-						if(i != last_msqu){
-							last_msqu = i;
-							pll_buf[0] = atten_calc(i) | ATTEN_MAIN | SQU_ADDR;
-							pll_ptr = 0;
-							pll_buf[1] = 0xffffffffL;
+						if((i == SOUT_VFOM_N) || (i == SOUT_VFOS_N)) j = PLLC_LEN - 1;	// worst case frames for this item
+						else j = 1;
+						if((i == SOUT_NONE_N) || ((U8)(pptr - pll_buf) + j >= PLL_BUF_MAX)) break;
+						sout_served++;												// age the other pending requests
+						c = i;														// trace cause
+						p0 = (U8)(pptr - pll_buf);
+						switch(i){													// each band's frames carry their own init frames (setpll())
+						case SOUT_VFOM_N:
+							pptr = setpll(bandid_m, pptr, sin_field(SEV_PTT), MAIN) - 1;	// update main pll (overwrite end semaphore)
+							sout_flags &= ~SOUT_VFOM_F;								// clear the signal
+							set_vfo_display(MAIN);									// send disp update signal
+							sv |= SV_MAIN;											// save affected VFO (after hand-off)
+							break;
+
+						case SOUT_VFOS_N:
+							pptr = setpll(bandid_s, pptr, 0, SUB) - 1;				// update sub pll
+							sout_flags &= ~SOUT_VFOS_F;
+							set_vfo_display(SUB_D);									// send disp update signal
+							sv |= SV_SUB;
+							break;
+
+						case SOUT_MVOL_N:											// process VOL/SQU triggers...
+							if((mute_band & MS_MUTE) || (bandid_m > ID1200_IDX)){
+								i = 0;												// 0 if muted
+							}else{
+								i = vol_m;
+							}
+							if(i != last_mvol){
+								last_mvol = i;
+								*pptr++ = atten_calc(i) | ATTEN_MAIN | VOL_ADDR;
+								mcf = 1;											// set to confirm mute
+							}
+							sout_flags &= ~SOUT_MVOL_F;								// clear signal flag
+							break;
+
+						case SOUT_SVOL_N:
+							if((mute_band & SUB_MUTE) || (bandid_s > ID1200_IDX)){
+								i = 0;
+							}else{
+								i = vol_s;
+							}
+							if(i != last_svol){
+								last_svol = i;
+								*pptr++ = atten_calc(i) | ATTEN_SUB | VOL_ADDR;
+								mcf = 1;											// set to confirm mute
+							}
+							sout_flags &= ~SOUT_SVOL_F;								// clear signal flag
+							break;
+
+						case SOUT_MSQU_N:
+							i = vfo_p[bandid_m].sq;
+							if(i != last_msqu){
+								last_msqu = i;
+								*pptr++ = atten_calc(i) | ATTEN_MAIN | SQU_ADDR;
+							}
+							sout_flags &= ~SOUT_MSQU_F;								// clear signal flag
+							break;
+
+						case SOUT_SSQU_N:
+							i = vfo_p[bandid_s].sq;
+							if(i != last_ssqu){
+								last_ssqu = i;
+								*pptr++ = atten_calc(i) | ATTEN_SUB | SQU_ADDR;
+							}
+							sout_flags &= ~SOUT_SSQU_F;								// clear signal flag
+							break;
+
+						case SOUT_TONE_N:											// send tone message
+							*pptr++ = (U32)vfo_p[bandid_m].ctcss | TONE_ADDR;
+							sout_flags &= ~SOUT_TONE_F;								// clear signal flag
+							break;
+
+						default:
+						case SOUT_VUPD_N:
+							push_vfo();												// save VFO
+							sout_flags &= ~SOUT_VUPD_F;
+							break;
 						}
-						sout_flags &= ~SOUT_MSQU_F;									// clear signal flag
-						break;
-
-					case SOUT_SSQU_N:
-						i = vfo_p[bandid_s].sq;
-						if(i != last_ssqu){
-							last_ssqu = i;
-							pll_buf[0] = atten_calc(i) | ATTEN_SUB | SQU_ADDR;
-							pll_ptr = 0;
-							pll_buf[1] = 0xffffffffL;
+						for(j=p0; j<(U8)(pptr - pll_buf); j++){
+							pll_cause[j] = c;										// tag the frames this item added
 						}
-						sout_flags &= ~SOUT_SSQU_F;									// clear signal flag
-						break;
-
-					case SOUT_TONE_N:												// send tone message
-						pll_buf[0] = (U32)vfo_p[bandid_m].ctcss | TONE_ADDR;
+					}while(sout_flags);
+					if(pptr != pll_buf){
+						if(mcf) *pptr = 0xfffffffeL;								// end of burst, confirm mute
+						else *pptr = 0xffffffffL;									// end of burst
 						pll_ptr = 0;
-						pll_buf[1] = 0xffffffffL;
-						sout_flags &= ~SOUT_TONE_F;									// clear signal flag
-						break;
-
-					default:
-					case SOUT_VUPD_N:
-						push_vfo();													// save VFO
-						sout_flags &= ~SOUT_VUPD_F;
-						break;
+						k = 0xff;													// processing...
 					}
-					if(pll_ptr == 0) k = 0xff;										// processing...
+				}else{
+					if(!ptt_cache_ok()) ptt_cache_build();							// nothing pending, refresh the PTT frame cache
+				}
+				if((pll_ptr == 0xff) && xit_rem && !xit_busy && sout_admit()){
+					if(xit_seq_next()) k = 0xff;									// send the next X/RIT chunk
 				}
 			}
 		}
-	}else{
-		// data is being sent branch ...
-		// wait for pacing timer
+	}
+	if(pll_ptr != 0xff){
+		// data is being sent branch (a new burst is handed off on the same pass) ...
 		k = 0xff;																	// set "processing" flag
-		if(!sout_time(0xff)){														// check for the pacing timer to expire
-			// send buffer, 1 word/pass
-			if((pll_buf[pll_ptr] & 0xfffffff0) != 0xfffffff0){						// (almost) all "f's" is end of buffer semaphore
+		if((pll_ptr != PLL_PTR_SEQ) && !sout_seq_busy()){
+			// hand the buffer to the SOUT sequence engine.  The engine paces the frames in HW and
+			//	calls sout_seq_done() when the last one has been sent.
+			j = 0;
+			xn = 0;
+			p0 = pll_ptr;
+			while((pll_ptr < PLL_BUF_MAX) && ((pll_buf[pll_ptr] & 0xfffffff0) != 0xfffffff0)){	// (almost) all "f's" is end of buffer semaphore
 				if((pll_buf[pll_ptr] & UX_XIT_MASK) != UX_XIT){						// process non-xit/rit messages
-//						putsQ("so1");	// !!!debug
-					send_so(pll_buf[pll_ptr++]);									// send next word
-					sout_time(SOUT_PACE_TIME);
-					if(pll_ptr >= PLL_BUF_MAX){										// check for hard-end-of-buffer
-						pll_ptr = 0xff;												// set end of tx
+					if(j < SOUT_SEQ_MAX){
+						so_cause[j] = pll_cause[pll_ptr];
+						so_seq[j++] = pll_buf[pll_ptr];
 					}
-				}else{																// process xit/rit as a sequence of PLL message that pulse an up-dn counter on the UX-129
-																					// mechanizing this reduces the 32bit buffer length needed to queue SOUT data
-					if(xit_count){													// if we are still counting:
-						if(xit_count & 0x01){
-							putsQ("x0");	// !!!debug
-							send_so(UX_XIT_CK0);									// alternate FE clk with..
-							sout_time(SOUT_PACE_TIME);
-						}else{
-							putsQ("x1");	// !!!debug
-							if(xit_dir) send_so(UX_XIT_CKUP);						// ...REF clk up,
-							else send_so(UX_XIT_CKDN);								// or dn
-							sout_time(SOUT_PACE_TIME);
-						}
-						if(--xit_count == 0) pll_ptr++;								// X/RIT done... next pll buffer
-					}else{
-						xit_count = (U8)(pll_buf[pll_ptr] & UX_XIT_COUNT) << 1;		// set up the count and direction
-						xit_dir = (U8)(pll_buf[pll_ptr] & UX_XIT_UP);
-						if(xit_count == 0) pll_ptr++;								// X/RIT done... next pll buffer
+				}else{																// xit/rit pulse an up-dn counter on the UX-129, hand it to the
+					if(xn < SOUT_SEQ_MAX){											// ..X/RIT sequencer so the pulses don't hold up this burst
+						xw[xn++] = (U8)(pll_buf[pll_ptr] & (UX_XIT_UP|UX_XIT_COUNT));
 					}
 				}
-			}else{
-				if(pll_buf[pll_ptr] == 0xfffffffe){									// look for mute confirm semaphore
-					mute_band |= 0x80;												// set muted flag
+				pll_ptr++;
+			}
+			if((pll_ptr < PLL_BUF_MAX) && (pll_buf[pll_ptr] == 0xfffffffe)){		// look for mute confirm semaphore
+				sout_mutecf = 1;													// set muted flag when the sequence is done
+			}
+			if(j){
+				pll_ptr = PLL_PTR_SEQ;
+				if(send_so_seq(so_seq, j, sout_seq_done)){
+					sout_trace(so_seq, so_cause, 0, j);
+					ptt_fast = 0;													// this sequence follows any fast path frames
+				}else{
+					pll_ptr = p0;													// PTT fast path has the engine, try again
+					xn = 0;															// (X/RIT words are re-collected on the retry)
 				}
-				pll_ptr = 0xff;														// set end of tx flag
+			}else{
+				pll_ptr = 0xff;														// nothing to send, set end of tx flag
+			}
+			for(i=0; i<xn; i++){
+				xit_seq_start(xw[i]);												// start X/RIT once the burst is committed
 			}
 		}
 	}
+	if(sv & SV_MAIN) save_vfo(bandid_m);											// save VFOs while the burst goes out
+	if(sv & SV_SUB) save_vfo(bandid_s);
 	return k;
 }
 
 //-----------------------------------------------------------------------------
-// save_vfo() copies VFO/offset to NVRAM
+// ptt_cache_ok() returns TRUE if the main band PTT frame cache matches the main VFO
+//-----------------------------------------------------------------------------
+U8 ptt_cache_ok(void){
+
+	if(pttc_bid != bandid_m) return FALSE;
+	if(pttc_vfo != vfo_p[bandid_m].vfo) return FALSE;
+	if(pttc_offs != vfo_p[bandid_m].offs) return FALSE;
+	if(pttc_dplx != vfo_p[bandid_m].dplx) return FALSE;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// ptt_cache_build() precomputes the main band RX and TX PLL sequences
+//-----------------------------------------------------------------------------
+void ptt_cache_build(void){
+	U8	otx = 0;
+	U32	ii;
+
+	pttc_bid = 0xff;										// invalidate while building (PTT fast path)
+	pll_frames(bandid_m, pttc_rx, 0, MAIN, &otx, &ii);		// RX (PTT off)
+	otx = 0;
+	pll_frames(bandid_m, pttc_tx, 1, MAIN, &otx, &pttc_txfrq);	// TX (from PTT off)
+	pttc_otx = otx;
+	pttc_bid = bandid_m;									// store key
+	pttc_vfo = vfo_p[bandid_m].vfo;
+	pttc_offs = vfo_p[bandid_m].offs;
+	pttc_dplx = vfo_p[bandid_m].dplx;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// ptt_cache_get() copies the cached main band sequence for a PTT edge to plldata
+//	and applies the same side effects as setpll().  returns FALSE on a cache miss.
+//	plldata == 0 applies the side effects only (sequence was sent by Timer3B_ISR()).
+//-----------------------------------------------------------------------------
+U8 ptt_cache_get(U8 is_tx, U32* plldata){
+	U8	i;
+	U32*	sptr;
+
+	if(!ptt_cache_ok()) return FALSE;
+	if(is_tx){
+		if(old_tx) return FALSE;							// TX sequence assumes PTT was off
+		sptr = pttc_tx;
+		old_tx = pttc_otx;
+		vfotr = pttc_txfrq;
+		sout_post(SOUT_TONE_F);								// trigger tone update if TX
+	}else{
+		sptr = pttc_rx;
+		old_tx = 0;
+		vfotr = vfo_p[bandid_m].vfo;
+	}
+	if(plldata){
+		for(i=0; i<PLL_BUF_MAX; i++){
+			plldata[i] = sptr[i];
+		}
+	}
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Timer3B_ISR() PTT fast path.  Software triggered from Timer2B_ISR() when the SIN
+//	SEND bit changes.  Sends the cached main band TX or RX sequence straight to the
+//	SOUT engine so a PTT edge does not wait on the main loop.  process_SOUT() still
+//	does the PTT housekeeping, and sends the sequence itself if this ISR could not
+//	(stale cache or PTT already on).  If the engine is busy, the send is retried
+//	from the sequence done callback.
+//-----------------------------------------------------------------------------
+void Timer3B_ISR(void){
+	U8	i;
+	U8	tx;
+	U32*	sptr;
+
+	tx = get_sin_send();
+	if(ptt_fast == (tx | PTTF_SENT)) return;				// already sent for this state
+	ptt_fast = 0;
+	ptt_fpend = 0;
+	lat_mark(LAT_PTT, get_sin_sendus());
+	if(!ptt_cache_ok()) return;								// stale cache, leave it to process_SOUT()
+	if(tx){
+		if(old_tx) return;									// TX sequence assumes PTT was off
+		sptr = pttc_tx;
+	}else{
+		sptr = pttc_rx;
+	}
+	for(i=0; (i < PLL_BUF_MAX) && (sptr[i] != 0xffffffffL); i++);
+	if(send_so_seq(sptr, i, ptt_seq_done)){
+		sout_trace(sptr, 0, SOTR_FPTT, i);
+		ptt_fast = tx | PTTF_SENT;
+	}else{
+		ptt_fpend = 1;										// engine busy, retry when it is done
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// ptt_seq_done() SOUT completion callback for PTT fast path sequences
+//-----------------------------------------------------------------------------
+void ptt_seq_done(void){
+
+	if(ptt_fpend) NVIC_SW_TRIG_R = INT_TIMER3B - 16;		// another SEND edge is waiting
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// xit_seq_start() queues a UX-129 X/RIT pulse train.  xreg is in X/RIT register format
+//	(REG_XIT_UP | count).  A train in the other direction is netted against the pulses
+//	not yet sent.
+//-----------------------------------------------------------------------------
+void xit_seq_start(U8 xreg){
+	U8	n = xreg & REG_XIT_CNT;
+	U8	d = (xreg & REG_XIT_UP) ? UX_XIT_UP : 0;
+
+	if((xit_rem == 0) || (d == xit_dir)){
+		xit_dir = d;
+		if(((U16)xit_rem + n) > 0xff) xit_rem = 0xff;
+		else xit_rem += n;
+	}else{
+		if(n <= xit_rem){
+			xit_rem -= n;											// net out
+		}else{
+			xit_rem = n - xit_rem;									// reverse direction
+			xit_dir = d;
+		}
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// xit_seq_next() sends the next X/RIT chunk (up to XIT_CHUNK pulses, each a REF clk
+//	up/dn frame followed by a FE clk frame).  returns TRUE if the chunk was started.
+//-----------------------------------------------------------------------------
+U8 xit_seq_next(void){
+	U8	i;
+	U8	n;
+
+	n = xit_rem;
+	if(n > XIT_CHUNK) n = XIT_CHUNK;
+	for(i=0; i<n; i++){
+		if(xit_dir) xit_seq[i * 2] = UX_XIT_CKUP;					// REF clk up,
+		else xit_seq[i * 2] = UX_XIT_CKDN;							// or dn, alternated..
+		xit_seq[(i * 2) + 1] = UX_XIT_CK0;							// ..with FE clk
+	}
+	xit_rem -= n;
+	xit_busy = 1;
+	if(!send_so_seq(xit_seq, n * 2, xit_seq_done)){
+		xit_rem += n;												// engine taken, try again next pass
+		xit_busy = 0;
+		return FALSE;
+	}
+	sout_trace(xit_seq, 0, SOTR_XIT, n * 2);
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// xit_seq_done() SOUT completion callback for X/RIT chunks.  counts a finished train
+//	and lets a waiting PTT edge in ahead of the next chunk.
+//-----------------------------------------------------------------------------
+void xit_seq_done(void){
+
+	xit_busy = 0;
+	if(xit_rem == 0) xit_done++;									// train complete
+	if(ptt_fpend) NVIC_SW_TRIG_R = INT_TIMER3B - 16;				// PTT fast path goes first
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// get_xit_stat() returns the X/RIT pulses still to send (0 = idle) and the completed
+//	train count in *done.  clears the count if clr == TRUE
+//-----------------------------------------------------------------------------
+U8 get_xit_stat(U16* done, U8 clr){
+
+	*done = xit_done;
+	if(clr) xit_done = 0;
+	if(xit_busy && (xit_rem == 0)) return 1;						// last chunk still in flight
+	return xit_rem;
+}
+
+//-----------------------------------------------------------------------------
+// sout_seq_done() SOUT sequence engine completion callback (called from SSI1_ISR)
+//-----------------------------------------------------------------------------
+void sout_seq_done(void){
+
+	pll_ptr = 0xff;											// set end of tx flag
+	if(ptt_fpend) NVIC_SW_TRIG_R = INT_TIMER3B - 16;		// run the deferred PTT fast path
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// lat_mark() arms a latency measurement (LAT_xxx) that starts at t0 (us).  an already
+//	armed class keeps its (earlier) start time.
+//-----------------------------------------------------------------------------
+void lat_mark(U8 lclass, U32 t0){
+	U32	pm;		// PRIMASK at entry
+
+	SOTR_LOCK(pm);
+	if(!lat_arm[lclass]){
+		lat_t0[lclass] = t0;
+		lat_arm[lclass] = 1;
+	}
+	SOTR_UNLOCK(pm);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// lat_hit() ends an armed latency measurement at t (us) and bins it.  call with SOTR_LOCK held.
+//-----------------------------------------------------------------------------
+void lat_hit(U8 lclass, U32 t){
+	U8	i;
+	U32	dt;
+
+	if(!lat_arm[lclass]) return;
+	lat_arm[lclass] = 0;
+	dt = t - lat_t0[lclass];
+	if(dt > lat_max[lclass]) lat_max[lclass] = dt;
+	for(i=0; (i < (LAT_BINS - 1)) && (dt >= ((U32)LAT_BIN0 << i)); i++);
+	if(lat_hist[lclass][i] != 0xffff) lat_hist[lclass][i]++;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sout_trace() logs a sequence that was just handed to the SOUT engine.  the frames go
+//	out back-to-back, so frame n starts SOUT_FRAME_US * n after the first.  cptr holds
+//	a cause for each frame, or if cptr == 0, all frames are logged with "cause".
+//	the first frame of a sequence for an armed latency class ends that measurement.
+//-----------------------------------------------------------------------------
+void sout_trace(U32* fptr, U8* cptr, U8 cause, U8 len){
+	U8	i;
+	U8	d;
+	U8	c;
+	U32	t;
+	struct sotr_struct* tp;
+	U32	pm;		// PRIMASK at entry
+
+	for(i=sout_flags, d=0; i; i &= i - 1, d++);					// pending request count
+	SOTR_LOCK(pm);
+	t = get_us();
+	for(i=0; i<len; i++, t += SOUT_FRAME_US){
+		if(cptr) c = cptr[i];
+		else c = cause;
+		tp = &sotr[sotr_w++ & SOTR_MASK];
+		tp->us = t;
+		tp->word = fptr[i];
+		tp->cause = c;
+		tp->depth = d;
+		switch(c){
+		case SOTR_PTT:
+		case SOTR_FPTT:
+			lat_hit(LAT_PTT, t);
+			break;
+
+		case SOUT_VFOM_N:
+		case SOUT_VFOS_N:
+			lat_hit(LAT_VFO, t);
+			break;
+
+		case SOUT_MVOL_N:
+		case SOUT_SVOL_N:
+			lat_hit(LAT_VOL, t);
+			break;
+
+		default:
+			break;
+		}
+	}
+	SOTR_UNLOCK(pm);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sout_trace_dump() lists the SOUT trace ring, oldest first.  one frame per line:
+//	<us> <hex word> <cause> <depth>
+//	us is the frame start time (1us, wraps at 2^32), cause is a SOUT_xxx_N ordinal (0-7)
+//	or SOTR_xxx (8 = PTT, 9 = PTT fast path, 10 = X/RIT, 11 = band off), depth is the
+//	number of SOUT requests still pending when the frame was queued.
+//-----------------------------------------------------------------------------
+void sout_trace_dump(void){
+	char	dbuf[40];
+	U16		i;
+	U16		n;
+	struct sotr_struct tr;
+	U32		pm;		// PRIMASK at entry
+
+	SOTR_LOCK(pm);
+	n = sotr_w;
+	SOTR_UNLOCK(pm);
+	if(n > SOTR_MAX) i = n - SOTR_MAX;
+	else i = 0;
+	sprintf(dbuf,"STRC n=%u frame=%uus", n - i, (U16)SOUT_FRAME_US);
+	putsQ(dbuf);
+	for( ; i != n; i++){
+		SOTR_LOCK(pm);
+		tr = sotr[i & SOTR_MASK];
+		SOTR_UNLOCK(pm);
+		sprintf(dbuf,"%u %08x %u %u", tr.us, tr.word, tr.cause, tr.depth);
+		putsQ(dbuf);
+	}
+	putsQ("STRC end");
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// lat_hist_dump() lists the latency histograms, one class per line:
+//	<class> max=<us> <count bin 0> .. <count bin LAT_BINS-1>
+//	bin n counts latencies < (LAT_BIN0 << n) us, the last bin is open ended.
+//-----------------------------------------------------------------------------
+void lat_hist_dump(void){
+	char	dbuf[120];
+	char*	sptr;
+	U8		i;
+	U8		j;
+	const char* lname[] = { "PTT", "VFO", "VOL" };
+
+	sprintf(dbuf,"LAT bin0 <%uus, x2/bin", LAT_BIN0);
+	putsQ(dbuf);
+	for(i=0; i<LAT_NUM; i++){
+		sptr = dbuf + sprintf(dbuf,"%s max=%u", lname[i], lat_max[i]);
+		for(j=0; j<LAT_BINS; j++){
+			sptr += sprintf(sptr," %u", lat_hist[i][j]);
+		}
+		putsQ(dbuf);
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// clr_sout_trace() clears the SOUT trace ring and the latency histograms
+//-----------------------------------------------------------------------------
+void clr_sout_trace(void){
+	U8	i;
+	U8	j;
+	U32	pm;		// PRIMASK at entry
+
+	SOTR_LOCK(pm);
+	sotr_w = 0;
+	for(i=0; i<LAT_NUM; i++){
+		lat_arm[i] = 0;
+		lat_max[i] = 0;
+		for(j=0; j<LAT_BINS; j++){
+			lat_hist[i][j] = 0;
+		}
+	}
+	SOTR_UNLOCK(pm);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// save_vfo() copies VFO/offset to the NVRAM cache
 //	call this fn anytime something changes in a VFO
 //	b_id == 0xff, saves all
 //	else, only save one indexed dataset
@@ -712,9 +1180,9 @@ void  save_vfo(U8 b_id){
 		stopid = b_id + 1;
 		if((get_xmode(b_id) & (MC_XFLAG)) && (b_id < ID1200)){
 			// if call or mem mode, just save mem/call#:
-			jj = SQ_0 + (VFO_LEN * startid);					// set start @ squ
-			rw8_nvr(jj, vfo_p[startid].sq, CS_WRITE|CS_OPEN);	// save squ and vol
-			rw8_nvr(jj, vfo_p[startid].vol, CS_WRITE|CS_CLOSE);
+			jj = VFO_LEN * startid;
+			nvc_wr(SQ_0 + jj, vfo_p[startid].sq, 1);			// save squ and vol
+			nvc_wr(VOL_0 + jj, vfo_p[startid].vol, 1);
 			return;												// exit now...
 		}
 	}
@@ -726,48 +1194,139 @@ void  save_vfo(U8 b_id){
 }
 
 //-----------------------------------------------------------------------------
-// nvwr_vfo() copies VFO struct to NVRAM
+// nvwr_vfo() copies VFO struct to the NVRAM cache (nvc_flush() writes it to NVRAM)
 //	call this fn anytime something changes in a VFO
 //	startid is first ID and stopid = last id + 1
 //-----------------------------------------------------------------------------
 void  nvwr_vfo(U8 startid, U8 stopid){
 	U8	i;
 	U32	jj;
-	U8	k;
 
-	// combine VFO/offset into single 32 bit value
-	k = CS_WRITE | CS_OPEN;
-	for(i=startid, jj=VFO_0 + (VFO_LEN * startid); i<stopid; i++){
-		rw32_nvr(jj, vfo_p[i].vfo, k);							// write each element of the band state in sequence
-		k = CS_WRITE;											// the addr (j) only matters for first call in an "OPEN" sequence.  So...
-																// we don't update it here (the NVRAM increments it automatically).  Saves
-		rw16_nvr(jj, vfo_p[i].offs, k);							// a lot of SPI clock cycles.
-		rw8_nvr(jj, vfo_p[i].dplx, k);
-		rw8_nvr(jj, vfo_p[i].ctcss, k);
-		rw8_nvr(jj, vfo_p[i].sq, k);
-		rw8_nvr(jj, vfo_p[i].vol, k);
+	for(i=startid; i<stopid; i++){
+		jj = VFO_LEN * i;
+		nvc_wr(VFO_0 + jj, vfo_p[i].vfo, 4);					// copy each element of the band state to its image address
+		nvc_wr(OFFS_0 + jj, vfo_p[i].offs, 2);
+		nvc_wr(DPLX_0 + jj, vfo_p[i].dplx, 1);
+		nvc_wr(CTCSS_0 + jj, vfo_p[i].ctcss, 1);
+		nvc_wr(SQ_0 + jj, vfo_p[i].sq, 1);
+		nvc_wr(VOL_0 + jj, vfo_p[i].vol, 1);
 		if(i >= ID1200){
-			rw8_nvr(jj, mem[i-ID1200], k);
-			rw8_nvr(jj, call[i-ID1200], k);
+			nvc_wr(MEM_0 + jj, mem[i-ID1200], 1);
+			nvc_wr(CALL_0 + jj, call[i-ID1200], 1);
 		}else{
-			rw8_nvr(jj, mem[i], k);
-			rw8_nvr(jj, call[i], k);
+			nvc_wr(MEM_0 + jj, mem[i], 1);
+			nvc_wr(CALL_0 + jj, call[i], 1);
 		}
-		rw8_nvr(jj, vfo_p[i].bflags, k);
-		rw8_nvr(jj, vfo_p[i].scanflags, k);
-		rw8_nvr(jj, vfo_p[i].tsa, k);
-		if(i == (stopid - 1)) k |= CS_CLOSE;
-		rw8_nvr(jj, vfo_p[i].tsb, k);
+		nvc_wr(BFLAGS_0 + jj, vfo_p[i].bflags, 1);
+		nvc_wr(SCANFLAGS_0 + jj, vfo_p[i].scanflags, 1);
+		nvc_wr(TSA_0 + jj, vfo_p[i].tsa, 1);
+		nvc_wr(TSB_0 + jj, vfo_p[i].tsb, 1);
+	}
+	nvc_wr(XIT_0, ux129_xit, 1);								// save xit/rit/bandid
+	nvc_wr(RIT_0, ux129_rit, 1);
+	nvc_wr(BIDM_0, bandid_m, 1);
+	nvc_wr(BIDS_0, bandid_s, 1);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// nvc_load() fills the VFO NVRAM cache from NVRAM (all records clean)
+//-----------------------------------------------------------------------------
+void  nvc_load(void){
+	U8	i;
+
+	nvr_read_block(VFO_0, nvc_img, NVC_LEN);
+	for(i=0; i<NVC_LEN; i++){
+		nvc_shd[i] = nvc_img[i];
 	}
-	rw8_nvr(XIT_0, ux129_xit, CS_WRITE | CS_OPEN);				// save xit/rit/bandid
-	rw8_nvr(RIT_0, ux129_rit, CS_WRITE);
-	rw8_nvr(BIDM_0, bandid_m, CS_WRITE);
-	rw8_nvr(BIDS_0, bandid_s, CS_WRITE | CS_CLOSE);
+	nvc_dirty = 0;
 	return;
 }
 
 //-----------------------------------------------------------------------------
-// save_mc() copies mem/call to NVRAM
+// nvc_wr() writes len bytes of dataw (lsb first, NVRAM byte order) to the VFO NVRAM
+//	cache at NVRAM address addr and marks the record dirty if anything changed.
+//	No SPI traffic.
+//-----------------------------------------------------------------------------
+void  nvc_wr(U32 addr, U32 dataw, U8 len){
+	U8	i;
+	U8	j;
+	U8	c = 0;
+
+	if(((addr - VFO_0) + len) > NVC_LEN) return;				// not in the cached region
+	i = (U8)(addr - VFO_0);
+	j = i / VFO_LEN;											// record (the trailer is record NUM_VFOS)
+	for( ; len; len--, dataw >>= 8, i++){
+		if(nvc_img[i] != (U8)dataw){
+			nvc_img[i] = (U8)dataw;
+			c = 1;
+		}
+	}
+	if(!c) return;												// no change
+	nvc_tl = get_free();
+	if(!nvc_dirty) nvc_t0 = nvc_tl;
+	nvc_dirty |= 1 << j;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// nvc_flush() writes the changed bytes of the dirty VFO NVRAM cache records to NVRAM.
+//	Runs from the main loop (process_IO()).  force == 0 only flushes after NVC_QUIET_MS
+//	of no writes, once the oldest dirty data is NVC_MAX_MS old, or on a VDD brown-out
+//	warning (BOR0).  Each changed span (image != shadow) is sent as one NVRAM message,
+//	and spans less than NVC_GAP bytes apart are merged (the gap bytes are cheaper to
+//	resend than a new WREN + WRITE + address).
+//-----------------------------------------------------------------------------
+void  nvc_flush(U8 force){
+	U8	a;
+	U8	e;
+	U8	j;
+	U32	t;
+
+	if(SYSCTL_RIS_R & SYSCTL_RIS_BOR0RIS){
+		SYSCTL_MISC_R = SYSCTL_MISC_BOR0MIS;					// power is failing, save now
+		force = 1;
+	}
+	if(!nvc_dirty) return;
+	if(!force){
+		t = get_free();
+		if(((t - nvc_tl) < NVC_QUIET_MS) && ((t - nvc_t0) < NVC_MAX_MS)) return;
+	}
+	a = 0;
+	while(a < NVC_LEN){
+		if(!(nvc_dirty & (1 << (a / VFO_LEN)))){
+			a = ((a / VFO_LEN) + 1) * VFO_LEN;					// clean record, skip it
+			continue;
+		}
+		if(nvc_img[a] == nvc_shd[a]){
+			a++;
+			continue;
+		}
+		e = a;													// changed span is [a, e]
+		for(j=a+1; (j<NVC_LEN) && (j <= (e + NVC_GAP)); j++){
+			if(nvc_img[j] != nvc_shd[j]) e = j;					// (clean records match their shadow)
+		}
+		nvc_span(a, e);
+		a = e + 1;
+	}
+	nvc_dirty = 0;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// nvc_span() writes nvc_img[s..e] to NVRAM in one message and updates the shadow
+//-----------------------------------------------------------------------------
+void  nvc_span(U8 s, U8 e){
+
+	nvr_write_block(VFO_0 + s, &nvc_img[s], e - s + 1);
+	for( ; s<=e; s++){
+		nvc_shd[s] = nvc_img[s];
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// save_mc() copies mem/call to the NVRAM cache
 //	call this fn anytime mem or call # changes
 //-----------------------------------------------------------------------------
 void  save_mc(U8 focus){
@@ -776,9 +1335,9 @@ void  save_mc(U8 focus){
 
 	if(focus == MAIN) i = bandid_m;
 	else i = bandid_s;
-	j = MEM_0 + (VFO_LEN * (U32)i);
-	rw8_nvr(j, mem[i], CS_WRITE | CS_OPEN);			// mem & call are adjacent in the NV map
-	rw8_nvr(j, call[i], CS_WRITE | CS_CLOSE);
+	j = VFO_LEN * (U32)i;
+	nvc_wr(MEM_0 + j, mem[i], 1);
+	nvc_wr(CALL_0 + j, call[i], 1);
 	return;
 }
 
@@ -803,39 +1362,30 @@ U8  get_bflag(U8 focus, U8 cmd, U8 bfset){
 //-----------------------------------------------------------------------------
 void  recall_vfo(void){
 	U8	i;
-	U32	j;
-	U8	k;
-	U8	startid;
-	U8	stopid;
-
-	startid = 0;
-	stopid = NUM_VFOS;
-	k = CS_OPEN;
-	for(i=startid, j=VFO_0; i<stopid; i++){
-		vfo_p[i].vfo = rw32_nvr(j, 0, k);
-		k = CS_IDLE;
-		vfo_p[i].offs = rw16_nvr(j, 0, k);
-		vfo_p[i].dplx = rw8_nvr(j, 0, k);
-		vfo_p[i].ctcss = rw8_nvr(j, 0, k);
-		vfo_p[i].sq = rw8_nvr(j, 0, k);
-		vfo_p[i].vol = rw8_nvr(j, 0, k);
+	U8*	rptr;
+
+	nvc_load();											// read the VFO region into the NVRAM cache (one message)..
+	for(i=0; i<NUM_VFOS; i++){							// ..and unpack each record
+		rptr = &nvc_img[VFO_LEN * i];
+		vfo_p[i].vfo = get_le(rptr, 4);
+		vfo_p[i].offs = (U16)get_le(rptr + (OFFS_0 - VFO_0), 2);
+		vfo_p[i].dplx = rptr[DPLX_0 - VFO_0];
+		vfo_p[i].ctcss = rptr[CTCSS_0 - VFO_0];
+		vfo_p[i].sq = rptr[SQ_0 - VFO_0];
+		vfo_p[i].vol = rptr[VOL_0 - VFO_0];
 		if(i < ID1200){
-			mem[i] = rw8_nvr(j, mem[i], k);
-			call[i] = rw8_nvr(j, 0, k);
-		}else{
-			rw8_nvr(j, mem[i], k);						// dummy reads
-			rw8_nvr(j, 0, k);
+			mem[i] = rptr[MEM_0 - VFO_0];
+			call[i] = rptr[CALL_0 - VFO_0];
 		}
-		vfo_p[i].bflags = rw8_nvr(j, 0, k);
-		vfo_p[i].scanflags = rw8_nvr(j, 0, k);
-		vfo_p[i].tsa = rw8_nvr(j, 0, k);
-		if(i == (stopid - 1)) k |= CS_CLOSE;
-		vfo_p[i].tsb = rw8_nvr(j, 0, k);
-	}
-	ux129_xit = rw8_nvr(XIT_0, 0, CS_OPEN);
-	ux129_rit = rw8_nvr(RIT_0, 0, CS_IDLE);
-	bandid_m = rw8_nvr(BIDM_0, 0, CS_IDLE);
-	bandid_s = rw8_nvr(BIDS_0, 0, CS_CLOSE);
+		vfo_p[i].bflags = rptr[BFLAGS_0 - VFO_0];
+		vfo_p[i].scanflags = rptr[SCANFLAGS_0 - VFO_0];
+		vfo_p[i].tsa = rptr[TSA_0 - VFO_0];
+		vfo_p[i].tsb = rptr[TSB_0 - VFO_0];
+	}
+	ux129_xit = nvc_img[XIT_0 - VFO_0];
+	ux129_rit = nvc_img[RIT_0 - VFO_0];
+	bandid_m = nvc_img[BIDM_0 - VFO_0];
+	bandid_s = nvc_img[BIDS_0 - VFO_0];
 	read_xmode();
 	vol_s = vfo_p[0].vol;								// restore vol s/m
 	vol_m = vfo_p[1].vol;
@@ -980,18 +1530,6 @@ void push_vfo(void){
 	return;
 }
 
-//-----------------------------------------------------------------------------
-// fetch_sin() returns the last valid SIN data based on the address param
-//	used to transfer local data to other source domains
-//-----------------------------------------------------------------------------
-U32  fetch_sin(U8 addr){
-	U32	ii;
-
-	if(addr) ii = sin_addr1;
-	else ii = sin_addr0;
-	return ii;
-}
-
 //-----------------------------------------------------------------------------
 // read_sin_flags() returns or clears the change flags
 //-----------------------------------------------------------------------------
@@ -1006,11 +1544,96 @@ U32  read_sin_flags(U32 flag){
 //-----------------------------------------------------------------------------
 void  vfo_change(U8 band){
 
-	if(band == MAIN) sout_flags |= SOUT_VFOM_F;
-	else sout_flags |= SOUT_VFOS_F;
+	lat_mark(LAT_VFO, get_us());
+	if(band == MAIN) sout_post(SOUT_VFOM_F);
+	else sout_post(SOUT_VFOS_F);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sout_post() posts SOUT requests (bitmap of SOUT_xxx_F)
+//	requests that are already pending are coalesced (they keep their place in line)
+//-----------------------------------------------------------------------------
+void  sout_post(U8 flags){
+	U8	i;
+	U8	j;
+
+	for(i=0, j=0x01; i<8; i++, j<<=1){
+		if(flags & j){
+			if(sout_flags & j){
+				sout_coal++;							// already pending, coalesce
+			}else{
+				sout_qstamp[i] = sout_served;			// stamp arrival
+				sout_flags |= j;
+			}
+		}
+	}
 	return;
 }
 
+//-----------------------------------------------------------------------------
+// sout_next() returns the ordinal of the next SOUT request to serve from the
+//	pending bitmap, "value".  Highest priority wins, ties go to the oldest.
+//	Requests that have waited SOUT_AGE_MAX services outrank everything.
+//	returns SOUT_NONE_N if nothing is pending.
+//-----------------------------------------------------------------------------
+U8 sout_next(U8 value){
+	U8	i;
+	U8	j;
+	U8	p;
+	U8	age;
+	U8	best = SOUT_NONE_N;
+	U8	bprio = 0;
+	U8	bage = 0;
+
+	for(i=0, j=0x01; i<8; i++, j<<=1){
+		if(value & j){
+			age = sout_served - sout_qstamp[i];
+			if(age >= SOUT_AGE_MAX) p = SOUT_PRIO_AGED;
+			else p = sout_prio[i];
+			if((best == SOUT_NONE_N) || (p > bprio) || ((p == bprio) && (age > bage))){
+				best = i;
+				bprio = p;
+				bage = age;
+			}
+		}
+	}
+	return best;
+}
+
+//-----------------------------------------------------------------------------
+// sout_admit() SOUT bus budget check for low-value traffic (vol/squ steps, scan steps).
+//	Returns FALSE while a PTT edge is waiting for process_SOUT(), or while a retune is
+//	pending and the bus is over SOUT_BW_HI % busy.  Held-off vol/squ signals stay pending,
+//	so repeated steps coalesce and only the last value goes out.
+//-----------------------------------------------------------------------------
+U8 sout_admit(void){
+
+	if(sin_field(SEV_PTT) != (U8)ptt_mem) return FALSE;						// PTT edge pending
+	if((sout_flags & (SOUT_VFOM_F|SOUT_VFOS_F)) && (get_sout_util() >= SOUT_BW_HI)) return FALSE;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// get_sout_bwdef() returns the SOUT bus budget deferral count, clears if clr == TRUE
+//-----------------------------------------------------------------------------
+U16 get_sout_bwdef(U8 clr){
+	U16	i = sout_bwdef;
+
+	if(clr) sout_bwdef = 0;
+	return i;
+}
+
+//-----------------------------------------------------------------------------
+// get_sout_coal() returns the SOUT coalesced request count, clears if clr == TRUE
+//-----------------------------------------------------------------------------
+U16 get_sout_coal(U8 clr){
+	U16	i = sout_coal;
+
+	if(clr) sout_coal = 0;
+	return i;
+}
+
 //-----------------------------------------------------------------------------
 // update_radio_all() sets the VFO flag to trigger a VFO update
 //-----------------------------------------------------------------------------
@@ -1020,37 +1643,37 @@ void  update_radio_all(U8 vector){
 	case UPDATE_ALL:
 	default:
 		sin_flags |= SIN_SQSM_F|SIN_SQSS_F|SIN_MSRF_F|SIN_SSRF_F|SIN_SEND_F|SIN_DSQA_F|SIN_DSQB_F|SIN_SEL_F|SIN_VFOM_F|SIN_VFOS_F;
-		sout_flags |= SOUT_MSQU_F|SOUT_SSQU_F|SOUT_MVOL_F|SOUT_SVOL_F|SOUT_VFOS_F|SOUT_VFOM_F;
+		sout_post(SOUT_MSQU_F|SOUT_SSQU_F|SOUT_MVOL_F|SOUT_SVOL_F|SOUT_VFOS_F|SOUT_VFOM_F);
 		break;
 
 	case MAIN_ALL:
 		sin_flags |= SIN_SQSM_F|SIN_MSRF_F|SIN_SEND_F|SIN_DSQA_F|SIN_SEL_F|SIN_VFOM_F;
-		sout_flags |= SOUT_MSQU_F|SOUT_MVOL_F|SOUT_VFOM_F;
+		sout_post(SOUT_MSQU_F|SOUT_MVOL_F|SOUT_VFOM_F);
 		break;
 
 	case SUB_ALL:
 		sin_flags |= SIN_SQSS_F|SIN_SSRF_F|SIN_DSQB_F|SIN_VFOS_F;
-		sout_flags |= SOUT_SSQU_F|SOUT_SVOL_F|SOUT_VFOS_F;
+		sout_post(SOUT_SSQU_F|SOUT_SVOL_F|SOUT_VFOS_F);
 		break;
 
 	case MAIN_FREQ:
 		sin_flags |= SIN_VFOM_F;
-		sout_flags |= SOUT_VFOM_F;
+		sout_post(SOUT_VFOM_F);
 		break;
 
 	case SUB_FREQ:
 		sin_flags |= SIN_VFOS_F;
-		sout_flags |= SOUT_VFOS_F;
+		sout_post(SOUT_VFOS_F);
 		break;
 
 	case MAIN_VQ:
 		sin_flags |= SIN_SQSM_F|SIN_MSRF_F|SIN_DSQA;
-		sout_flags |= SOUT_MSQU_F|SOUT_MVOL_F;
+		sout_post(SOUT_MSQU_F|SOUT_MVOL_F);
 		break;
 
 	case SUB_VQ:
 		sin_flags |= SIN_SQSS_F|SIN_SSRF_F|SIN_DSQB;
-		sout_flags |= SOUT_SSQU_F|SOUT_SVOL_F;
+		sout_post(SOUT_SSQU_F|SOUT_SVOL_F);
 		break;
 	}
 	return;
@@ -1072,7 +1695,7 @@ void  force_push_radio(void){
 	set_tonenv(SUB);
 	set_bandnv();
 */
-	sout_flags |= (SOUT_MSQU_F | SOUT_SSQU_F | SOUT_MVOL_F | SOUT_SVOL_F | SOUT_VUPD_F | SOUT_VFOS_F | SOUT_VFOM_F);
+	sout_post(SOUT_MSQU_F | SOUT_SSQU_F | SOUT_MVOL_F | SOUT_SVOL_F | SOUT_VUPD_F | SOUT_VFOS_F | SOUT_VFOM_F);
 	return;
 }
 
@@ -1148,11 +1771,11 @@ U8 adjust_squ(U8 mainsub, S8 value){
 		if(mainsub){
 			vfo_p[bandid_m].sq = i;										// store main
 			j = vfo_p[bandid_m].sq;
-			sout_flags |= SOUT_MSQU_F;									// send signal to update B-unit
+			sout_post(SOUT_MSQU_F);										// send signal to update B-unit
 		}else{
 			vfo_p[bandid_s].sq = i;										// store sub
 			j = vfo_p[bandid_s].sq;
-			sout_flags |= SOUT_SSQU_F;									// send signal to update B-unit
+			sout_post(SOUT_SSQU_F);										// send signal to update B-unit
 		}
 	}else{
 		i = value;														// +/- branch
@@ -1161,13 +1784,13 @@ U8 adjust_squ(U8 mainsub, S8 value){
 			if(vfo_p[bandid_m].sq > 0x7f) vfo_p[bandid_m].sq = 0;
 			if(vfo_p[bandid_m].sq > LEVEL_MAX) vfo_p[bandid_m].sq = LEVEL_MAX;
 			j = vfo_p[bandid_m].sq;
-			if(value != 0) sout_flags |= SOUT_MSQU_F;					// send signal to update B-unit
+			if(value != 0) sout_post(SOUT_MSQU_F);						// send signal to update B-unit
 		}else{
 			vfo_p[bandid_s].sq += i;									// adjust sub +/-
 			if(vfo_p[bandid_s].sq > 0x7f) vfo_p[bandid_s].sq = 0;
 			if(vfo_p[bandid_s].sq > LEVEL_MAX) vfo_p[bandid_s].sq = LEVEL_MAX;
 			j = vfo_p[bandid_s].sq;
-			if(value != 0) sout_flags |= SOUT_SSQU_F;					// send signal to update B-unit
+			if(value != 0) sout_post(SOUT_SSQU_F);						// send signal to update B-unit
 		}
 	}
 	if(mainsub == MAIN) set_qnv(MAIN);									// store to NVRAM
@@ -1185,11 +1808,11 @@ U8 adjust_vol(U8 mainsub, S8 value){
 		if(mainsub){
 			vol_m = i;													// store main
 			j = vol_m;
-			sout_flags |= SOUT_MVOL_F;									// send signal to update B-unit
+			sout_post(SOUT_MVOL_F);										// send signal to update B-unit
 		}else{
 			vol_s = i;													// store sub
 			j = vol_s;
-			sout_flags |= SOUT_SVOL_F;									// send signal to update B-unit
+			sout_post(SOUT_SVOL_F);										// send signal to update B-unit
 		}
 	}else{
 		i = value;														// +/- branch
@@ -1198,15 +1821,16 @@ U8 adjust_vol(U8 mainsub, S8 value){
 			if(vol_m > 0x7f) vol_m = 0;
 			if(vol_m > LEVEL_MAX) vol_m = LEVEL_MAX;
 			j = vol_m;
-			if(value != 0) sout_flags |= SOUT_MVOL_F;					// send signal to update B-unit
+			if(value != 0) sout_post(SOUT_MVOL_F);						// send signal to update B-unit
 		}else{
 			vol_s += i;													// adjust sub +/-
 			if(vol_s > 0x7f) vol_s = 0;
 			if(vol_s > LEVEL_MAX) vol_s = LEVEL_MAX;
 			j = vol_s;
-			if(value != 0) sout_flags |= SOUT_SVOL_F;					// send signal to update B-unit
+			if(value != 0) sout_post(SOUT_SVOL_F);						// send signal to update B-unit
 		}
 	}
+	if(value) lat_mark(LAT_VOL, get_us());
 	if(mainsub == MAIN) set_vnv(MAIN);									// store to NVRAM
 	else set_vnv(SUB);
 	return j;															// return current value
@@ -1229,7 +1853,7 @@ U8 adjust_tone(U8 mainsub, S8 value){
 			k = vfo_p[bandid_m].ctcss & (~CTCSS_MASK);					// mask control bits
 			vfo_p[bandid_m].ctcss = i | k;								// store main
 			j = vfo_p[bandid_m].ctcss;
-			sout_flags |= SOUT_TONE_F;									// send signal to update B-unit
+			sout_post(SOUT_TONE_F);										// send signal to update B-unit
 		}else{
 			k = vfo_p[bandid_s].ctcss & (~CTCSS_MASK);					// mask control bits
 			vfo_p[bandid_s].ctcss = i | k;								// store sub
@@ -1245,7 +1869,7 @@ U8 adjust_tone(U8 mainsub, S8 value){
 			if((k > CTCSS_MASK) || (k == 0)) k = TONE_MAX;
 			j = (vfo_p[bandid_m].ctcss & (~CTCSS_MASK)) | k;			// adjust main +/-
 			vfo_p[bandid_m].ctcss = j;
-			if(!value) sout_flags |= SOUT_TONE_F;						// send signal to update B-unit
+			if(!value) sout_post(SOUT_TONE_F);							// send signal to update B-unit
 		}else{
 			k = vfo_p[bandid_s].ctcss & CTCSS_MASK;
 			k += i;
@@ -1253,7 +1877,7 @@ U8 adjust_tone(U8 mainsub, S8 value){
 			if((k > CTCSS_MASK) || (k == 0)) k = TONE_MAX;
 			j = (vfo_p[bandid_s].ctcss & (~CTCSS_MASK)) | k;			// adjust sub +/-
 			vfo_p[bandid_s].ctcss = j;
-			if(!value) sout_flags |= SOUT_TONE_F;						// send signal to update B-unit
+			if(!value) sout_post(SOUT_TONE_F);							// send signal to update B-unit
 		}
 	}
 	if(mainsub == MAIN) set_tonenv(MAIN);								// store to NVRAM
@@ -1284,7 +1908,7 @@ U8 adjust_toneon(U8 mainsub, U8 value){
 			}else{
 				vfo_p[bandid_m].ctcss |= CTCSS_OFF;						// turn off
 			}
-			sout_flags |= SOUT_TONE_F;									// send signal to update B-unit
+			sout_post(SOUT_TONE_F);										// send signal to update B-unit
 		}else{
 			if(value){
 				vfo_p[bandid_s].ctcss &= ~CTCSS_OFF;					// turn on
@@ -1310,292 +1934,68 @@ U8 adjust_toneon(U8 mainsub, U8 value){
 //	plldata		a pointer to the U32 data buffer
 //	is_tx		a boolean flag to indicate TX (true) or RX (false)
 //	is_main		true for main band, false for sub band
+// The last sequence built for each of main/sub is cached (keyed on band, VFO, offset,
+//	duplex/power, TX and PTT state), so re-sending an unchanged VFO is a copy.
 //-----------------------------------------------------------------------------
 U32* setpll(U8 bid, U32* plldata, U8 is_tx, U8 is_main){
-    U8	i = 0;			// pll array index
-    U8	band_idr;		// temps
-    U32	ux_noptt;
-    U32	ux_ptt;
-    U32	pll;
-    U32	ii;
-    U32	jj;
-    U32	tt;
-    U32	*	pllptr = plldata;
-static U8	old_tx;
-/*
-#define SOUT_MAIN	0x04000000L
-#define SOUT_SUB	0x02000000L
-#define SOUT_PON	0x01000000L
-#define SOUT_LOHI	0x00800000L
-#define SOUT_BAND	0x00400000L
-#define SOUT_PTT	0x00200000L	// band unit PTT
-*/
+	U8	k;
+	struct pllc_struct* cp;
 
 	if((!is_tx) && is_main) old_tx = 0;
-    band_idr = get_modulid(vfo_p[bid].vfo / 1000L);		// use vfo frequency to determine band ID
-    ux_noptt = band_idr << 27;							// align band ID in SOUT proto word
-    if(is_main){
-    	ux_noptt |= SOUT_MAIN | SOUT_PON;				// set module pre-amble bits (main)
-    }else{
-    	ux_noptt |= SOUT_SUB | SOUT_PON;				// .. (sub)
-    }
-    if(vfo_p[bid].dplx & LOHI_F){
-    	ux_noptt |= SOUT_LOHI;							// set RF power level
+    if(is_tx) sout_post(SOUT_TONE_F);					// trigger tone update if TX
+    if(is_main) cp = &pllc[MAIN];
+    else cp = &pllc[SUB];
+    if((cp->bid != bid) || (cp->vfo != vfo_p[bid].vfo) || (cp->offs != vfo_p[bid].offs) ||
+       (cp->dplx != vfo_p[bid].dplx) || (cp->is_tx != is_tx) || (cp->otx_in != old_tx)){
+    	cp->otx_in = old_tx;							// cache miss, rebuild the entry
+    	cp->otx = old_tx;
+    	cp->len = (U8)(pll_frames(bid, cp->frm, is_tx, is_main, &cp->otx, &cp->trfrq) - cp->frm);
+    	cp->bid = bid;									// store key
+    	cp->vfo = vfo_p[bid].vfo;
+    	cp->offs = vfo_p[bid].offs;
+    	cp->dplx = vfo_p[bid].dplx;
+    	cp->is_tx = is_tx;
     }
-    ux_ptt = ux_noptt | SOUT_PTT;						// set PTT in is_tx proto word
-    if(is_tx){
-    	switch(vfo_p[bid].dplx & (DPLX_P|DPLX_M)){		// calculate TX frequency (if is_tx)
-    	default:
-    	case DPLX_S:
-    		vfotr = vfo_p[bid].vfo;
-    		break;
-
-    	case DPLX_M:
-    		vfotr = vfo_p[bid].vfo - (U32)vfo_p[bid].offs;
-    		break;
-
-    	case DPLX_P:
-    		vfotr = vfo_p[bid].vfo + (U32)vfo_p[bid].offs;
-    		break;
-    	}
-    }else{
-    	vfotr = vfo_p[bid].vfo;							// no TX, no calc needed
-    }
-	// !!!
-/*	char tgbuf[20];
-	sprintf(tgbuf,"frq: %d",vfotr); //!!!
-	putsQ(tgbuf);
-*/
-    //
-    if(is_tx) sout_flags |= SOUT_TONE_F;				// trigger tone update if TX
-    //
-    // use calculated band_id to dispatch to module specific PLL calculations
-    //	construct band select bitmap
-    //	convert VFO freq to chanelized value for PLL formatting
-    switch (band_idr & 0x0f) {
-    case ID10M:
-        pll = (vfotr - BASE_RX_10M) / 5L;				// convert to 5KHz chan
-        pll += PLL_10M;									// add base PLL bitmap
-        if (is_tx) {
-            pll -= BASE_TX_10M;							// subtract tx offset (for 10M and 6M)
-       }
-        pll <<= 1;										// align bitmap (only for 10M and 6M)
-        if(old_tx){
-        	pllptr[i++] = ux_ptt | INIT_PLL_10M;			// store init frame w/ ptt on
-        }else{
-        	pllptr[i++] = ux_noptt | INIT_PLL_10M;		// store init frame
-        }
-        if(is_main){
-            if(!old_tx){
-            	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-            	old_tx = is_tx;
-            }
-        }else{
-        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-        }
-        if(is_tx){
-            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
-        }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-        break;
-
-    case ID6M:
-        pll = (vfotr - BASE_RX_6M) / 5L;				// convert to 5KHz chan
-        pll += PLL_6M;									// add base PLL bitmap
-        if (is_tx) {
-            pll -= BASE_TX_6M;							// subtract tx offset (for 10M and 6M)
-        }
-        pll <<= 1;										// align bitmap (only for 10M and 6M)
-        if(old_tx){
-        	pllptr[i++] = ux_ptt | INIT_PLL_6M;			// store init frame w/ ptt on
-        }else{
-        	pllptr[i++] = ux_noptt | INIT_PLL_6M;		// store init frame
-        }
-        if(is_main){
-            if(!old_tx){
-            	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-            	old_tx = is_tx;
-            }
-        }else{
-        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-        }
-        if(is_tx){
-            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
-        }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-        break;
-
-    case ID2M:
-        pll = (vfotr - BASE_RX_2M) / 5L;				// convert to 5KHz chan
-        pll += PLL_2M;									// add base PLL bitmap
-        if (is_tx) {
-            pll += BASE_TX_2M;							// add tx offset
-        }
-        // insert a "0" into bit 7
-        pll = ((pll << 1) & 0x3ff80L) | (pll & 0x003fL);
-        if(is_main){
-            if(!old_tx){
-            	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-            	old_tx = is_tx;
-            }
-        }else{
-        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-        }
-        if(is_tx){
-            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
-        }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-        break;
-
-    case ID220:
-        pll = (vfotr - BASE_RX_220) / 5L;				// convert to 5KHz chan
-        pll += PLL_220;									// add base PLL bitmap
-        if (is_tx) {
-            pll += BASE_TX_220;							// add tx offset
-        }
-        // insert a "0" into bit 7
-        pll = ((pll << 1) & 0x3ff80L) | (pll & 0x003fL);
-        if(is_main){
-            if(!old_tx){
-            	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-            	old_tx = is_tx;
-            }
-        }else{
-        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-        }
-        if(is_tx){
-            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
-        }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-        break;
-
-    case ID440:
-        pll = (vfotr - BASE_RX_440) / 5L;				// convert to 5KHz chan
-        pll += PLL_440;									// add base PLL bitmap
-        if (is_tx) {
-            pll += BASE_TX_440;							// add tx offset
-        }
-        if(is_main){
-            if(!old_tx){
-            	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-            	old_tx = is_tx;
-            }
-        }else{
-        	pllptr[i++] = ux_noptt | pll;				// on 1st pass, don't turn on PTT
-        }
-        if(is_tx){
-            pllptr[i++] = ux_ptt | pll;					// store PLL plus PTT
-        }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-        break;
-
-    case ID1200:
-        pll = (vfotr - BASE_RX_1200) / 10L;				// convert to 10KHz chan
-        pll += PLL_1200;							    // add base PLL bitmap
-        if (is_tx) {
-            pll += BASE_TX_1200;					    // add tx offset
-        }
-        // insert a "0" into bit 6 ==> [...ponmlkjihg0fedcba]
-        pll = ((pll << 1) & 0x3ff80L) | (pll & 0x003fL);
-        // add "code" bits for N-frame
-        pll |= PLL_1200_N;
-        // bit reverse... tt will contain the new, bit-reversed PLL frame
-        for (ii = 0x80000L, jj = 1L, tt = 0L; ii != 0; ii >>= 1, jj <<=1) {
-            if (pll & ii) tt |= jj;
-        }
-        pllptr[i++] = ux_noptt | INIT_PLL_1200;			// init frame
-        pllptr[i++] = ux_noptt | tt;					// store PLL plus bit length
-        if(is_tx){
-        	ux_noptt = ux_ptt;
-            pllptr[i++] = ux_ptt | tt;					// store PLL plus PTT
-        }
-        pllptr[i++] = ux_ptt | INIT_PLL_1201;			// post-init frames
-        pllptr[i++] = ux_ptt | INIT_PLL_1202;
-        pllptr[i++] = ux_ptt | INIT_PLL_1203;
-        if(is_tx){
-            pllptr[i] = UX_XIT | (ux129_xit & (REG_XIT_UP | REG_XIT_CNT));
-        }else{
-            pllptr[i] = UX_XIT | (ux129_rit & (REG_XIT_UP | REG_XIT_CNT));
-       }
-        pllptr[i] = 0xffffffff;							// set end of PLL update string
-       break;
-
-    default:											// error trap, set end of update string
-        band_idr = 0;
-        pllptr[0] = 0xffffffff;							// set empty PLL update string
-        i = 0xff;
-        break;
+    for(k=0; k<cp->len; k++){
+    	plldata[k] = cp->frm[k];						// copy cached sequence
     }
-    return &pllptr[i+1];
-}
-
-///////////////////////////////////////////////////////////////////////////////
-//-----------------------------------------------------------------------------
-// get_modulid() calculates band id (1-6) from input freq (MHz)
-//	and set wide-band bit if outside the ham RX limits
-//-----------------------------------------------------------------------------
-U8 get_modulid(U32 freqMM){
-    U8	j;
-    U8	k;
-    U8	i = BANDOFF;
-
-    k = (U8)(freqMM / 100);
-    switch (k) {
-    case 0:										// is 10M or 6M?
-        j = (U8)(freqMM);
-        if ((j > 39) && (j < 61)) {				// is 6M (MM MM between 0040 and 0061)?
-            i = ID6M;
-            if ((j < 50) || (j >= 54)) {
-                i |= (BNDID_WBIF >> BND_SHIFT);	// enable wide band RX (BAND = 1)
-            }
-        }
-        else {
-            if ((j >= 20) && (j < 40)) {		// is 10M (MM MM between 0020 and 0040)?
-                i = ID10M;						// is 10M
-            }
-        }
-        break;
-
-    case 1:										// is 2M ?
-        j = (U8)(freqMM - 100);
-        if ((j > 19) && (j < 71)) {				// is 2M (MM MM between 0120 and 0170)?
-            i = ID2M;
-            if ((j < 44) || (j >= 48)) {
-                i |= (BNDID_WBIF >> BND_SHIFT);	// enable wide band RX (BAND = 1)
-            }
-        }
-        break;
-
-    case 2:										// is 220 ?
-        j = (U8)(freqMM - 200);
-        if ((j > 19) && (j < 26)) {				// is 2M (MM MM between 0220 and 0225)?
-            i = ID220;
-        }
-        break;
-
-    case 4:										// is 440 ?
-        j = (U8)(freqMM - 400);
-        if (j < 56) {					        // is UHF (MM MM between 0400 and 0455)?
-            i = ID440;
-        }
-        break;
-
-    case 12:									// is 1200 ?
-        i = ID1200;
-        break;
-
-    case 13:									// is 1300 - 1320 ?
-        j = (U8)(freqMM - 1300);
-        if (j < 21) {
-            i = ID1200;
-        }
-        break;
-
-    default:
-        i = BANDOFF;							// is error
-        break;
-    }
-    return i;
+    old_tx = cp->otx;
+    vfotr = cp->trfrq;
+	return &plldata[cp->len];
+}
+
+//-----------------------------------------------------------------------------
+// pll_frames() builds the SOUT frame sequence for setpll() from vfo_p[bid] (see pll_build())
+//-----------------------------------------------------------------------------
+U32* pll_frames(U8 bid, U32* plldata, U8 is_tx, U8 is_main, U8* otx, U32* trptr){
+
+	return pll_build(vfo_p[bid].vfo, vfo_p[bid].offs, vfo_p[bid].dplx, plldata, is_tx, is_main, otx, trptr);
+}
+
+//-----------------------------------------------------------------------------
+// pll_sweep() times a pll_build() sweep and checks the frame stream CRC against
+//	PLL_SWEEP_CRC.  Any change to the PLL code that alters the SOUT protocol shows
+//	up as a CRC fail.  PLL_SWEEP_CRC is generated on a host by host_test/pll_sweep_gen.c
+//	(same pll_frm.c source).  Over the ham ranges only, that sweep gives 0xaaf2, the
+//	value captured from the original switch-based setpll().  On a fail, the host
+//	harness shows which band, mode and frequency changed.
+//	Blocks for several seconds, debug use only.
+//-----------------------------------------------------------------------------
+void pll_sweep(void){
+	U16	crc = 0;
+	U32	n;
+	U32	t;
+	char	dbuf[60];
+
+	t = free_run();
+	n = pll_sweep_pass(0, 0);								// timed pass (no crc)
+	t = free_run() - t;
+	pll_sweep_pass(&crc, 0);								// check pass
+	sprintf(dbuf,"PLL sweep: %u frames, %u ms, %u ns/frame", n, t, (t * 1000) / (n / 1000));
+	putsQ(dbuf);
+	sprintf(dbuf,"CRC %04x (golden %04x) %s", crc, PLL_SWEEP_CRC, (crc == PLL_SWEEP_CRC) ? "PASS" : "FAIL");
+	putsQ(dbuf);
+	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1692,27 +2092,30 @@ S8 is_mic_updn(U8 ipl, U8 focus, U8 xmq){
 	static	S8	i;			// return value
 	static	U8	click_mem;	// button pressed memory
 			S8	rtn = 0;
+			U8	mck = 0;	// MIC clock edge
+			U16	ev;			// SIN event
 
 	if(ipl){
 		i = 0;				// init statics
 		click_mem = 0;
 		return 0;
 	}
-	if(sin_flags & SIN_MCK_F){								// if edge flag...
-		if(sin_addr1 & SIN_MCK){							// u/d "clock" active
+	while(get_sin_event(SEVC_MIC, &ev)){
+		if(SEV_ID(ev) == SEV_MCK) mck = 1;					// collect MIC clock edges
+	}
+	if(mck){												// if edge flag...
+		if(sin_field(SEV_MCK)){								// u/d "clock" active
 			micdb_time(1);									// set debounce timer
 			i = 0;											// clear statics
 			click_mem = 0;
 		}
-		read_sin_flags(SIN_MCK_F);
 	}else{
 		if(!click_mem){
-			if((!micdb_time(0)) && (sin_addr1 & SIN_MCK)){
+			if((!micdb_time(0)) && sin_field(SEV_MCK)){
 				mic_time(2);								// set long gap time for first press
-		    	if((sin_addr1 & (SIN_MUP | SIN_MCK)) == (SIN_MUP | SIN_MCK)){
+		    	if(sin_field(SEV_MUP)){
 		    		i = 1;									// if up button pressed, set +
-		    	}
-		    	if((sin_addr1 & (SIN_MUP | SIN_MCK)) == (SIN_MCK)){
+		    	}else{
 		    		i = -1;									// if dn button pressed, set -
 		    	}
 	    		do_dial_beep();								// beep
@@ -1720,7 +2123,7 @@ S8 is_mic_updn(U8 ipl, U8 focus, U8 xmq){
 				rtn = i;
 			}
 		}else{
-			if((!mic_time(0)) && (sin_addr1 & SIN_MCK)){
+			if((!mic_time(0)) && sin_field(SEV_MCK)){
 				mic_time(1);								// set short gap time for hold press
 				// if mem mode & no scan, start scan
 				if(focus == MAIN){
@@ -2202,7 +2605,7 @@ U8 inv_vfo(U8 focus){
 void mute_radio(U8 mutefl){
 
 	mute_band = mutefl;
-	sout_flags |= SOUT_MVOL_F | SOUT_SVOL_F;			// set signal flag
+	sout_post(SOUT_MVOL_F | SOUT_SVOL_F);				// set signal flag
 	return;
 }
 
@@ -2248,72 +2651,294 @@ void read_mem(U8 focus, U8 memnum){
 // write_nvmem() writes the vfo state to the nv memory space
 //-----------------------------------------------------------------------------
 void write_nvmem(U8 band, U8 memnum){
+	U8	rec[MEM_LEN];
+
+	pack_mem(rec, vfo_p[band].vfo, vfo_p[band].offs, vfo_p[band].dplx, vfo_p[band].ctcss, vfo_p[band].sq,
+			 ux129_xit, ux129_rit, band, mname_get(band));
+	nvr_write_mem(band, memnum, rec);
+	mcache_inval(band, memnum);
+	scanix_upd(band, memnum, vfo_p[band].dplx & SCANEN_F);
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// read_nvmem() read the vfo state from the nv memory space (via the mem cache)
+//-----------------------------------------------------------------------------
+void read_nvmem(U8 band, U8 memnum){
+	struct mcache_struct* mp;
+
+	mp = &mcache[mcache_load(band, memnum)];			// cache hit, or read the record
+	vfo_p[band].vfo = mp->vfo;
+	vfo_p[band].offs = mp->offs;
+	vfo_p[band].dplx = mp->dplx;
+	vfo_p[band].ctcss = mp->ctcss;
+	vfo_p[band].sq = mp->sq;							// (MEMR_VOL is deprecated !!! this will be a recall of the spare: vfo_p[band].spare)
+	ux129_xit = mp->xit;
+	ux129_rit = mp->rit;
+	mname_mem[band] = memnum;							// name is read when it is needed
+	mname_ok &= ~(1 << band);
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// mname_get() returns the name of the last mem read into the band.  The name is
+//	read from the name region on first use.
+//-----------------------------------------------------------------------------
+char* mname_get(U8 band){
+
+	if(!(mname_ok & (1 << band))){
+		nvr_read_block(get_mnameaddr(band, mname_mem[band]), (U8*)memname[band], MEM_NAME_LEN);
+		memname[band][MEM_NAME_LEN] = '\0';
+		mname_ok |= 1 << band;
+	}
+	return memname[band];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// mcache_find() returns the mem cache index of bid/memnum, or MCACHE_LEN if not cached
+//-----------------------------------------------------------------------------
+U8 mcache_find(U8 bid, U8 memnum){
+	U8	i;
+
+	for(i=0; i<MCACHE_LEN; i++){
+		if((mcache[i].bid == bid) && (mcache[i].mem == memnum)) break;
+	}
+	return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// mcache_load() returns the mem cache index of bid/memnum.  On a miss, the hot part
+//	of the record is read from NV space and decoded into the next (round-robin) entry.
+//-----------------------------------------------------------------------------
+U8 mcache_load(U8 bid, U8 memnum){
 	// mem structure follows this format:
 	// VFO + OFFS + DPLX + CTCSS + SQ + VOL + XIT + RIT + BID + MEM_NAME_LEN
-	U32	addr;		// temps
+	U8	rec[MEMH_LEN];
+	U8	k;
+	struct mcache_struct* mp;
+
+	k = mcache_find(bid, memnum);
+	if(k < MCACHE_LEN) return k;
+	k = mcache_nxt;
+	mcache_nxt = (mcache_nxt + 1) % MCACHE_LEN;
+	mp = &mcache[k];
+	nvr_read_mem(bid, memnum, rec, MEMH_LEN);			// hot fields only
+	mp->vfo = get_le(&rec[MEMR_VFO], 4);
+	mp->offs = (U16)get_le(&rec[MEMR_OFFS], 2);
+	mp->dplx = rec[MEMR_DPLX];
+	mp->ctcss = rec[MEMR_CTCSS];
+	mp->sq = rec[MEMR_SQ];
+	mp->xit = rec[MEMR_XIT];
+	mp->rit = rec[MEMR_RIT];
+	mp->bid = bid;
+	mp->mem = memnum;
+	return k;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// mcache_inval() invalidates the mem cache entry for bid/memnum (call after any
+//	write to a mem record).  bid = MCACHE_ALL empties the cache.
+//-----------------------------------------------------------------------------
+void mcache_inval(U8 bid, U8 memnum){
 	U8	i;
+
+	for(i=0; i<MCACHE_LEN; i++){
+		if((bid == MCACHE_ALL) || ((mcache[i].bid == bid) && (mcache[i].mem == memnum))){
+			mcache[i].bid = MCACHE_ALL;
+		}
+	}
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// mcache_prefetch() is called from the idle loop.  For each band in mem scan, it
+//	walks the scan-enable index forward from the current mem and loads the first of
+//	the next MCACHE_AHEAD enabled mems that is not yet cached (one record per call,
+//	so the NVRAM time per pass is bounded).  The look-ahead stays in the current
+//	band; after a sub-scan band switch, the first step of the new band is a miss.
+//-----------------------------------------------------------------------------
+void mcache_prefetch(void){
+	U8	xq;
+	U8	bid;
 	U8	j;
-	char* cptr;
-
-	addr = mem_band[band] + (memnum * MEM_LEN);
-	j = CS_WRITE;
-	rw32_nvr(addr, vfo_p[band].vfo, j|CS_OPEN);
-	rw16_nvr(addr, vfo_p[band].offs, j);
-	rw8_nvr(addr, vfo_p[band].dplx, j);
-	rw8_nvr(addr, vfo_p[band].ctcss, j);
-	rw8_nvr(addr, vfo_p[band].sq, j);
-	rw8_nvr(addr, 0, j);								// vol deprecated (vfo_p[band].vol now a spare) //
-	rw8_nvr(addr, ux129_xit, j);
-	rw8_nvr(addr, ux129_rit, j);
-	rw8_nvr(addr, band, j);
-	cptr = memname[band];
-	for(i=0; i<MEM_NAME_LEN; i++){
-		if(i == (MEM_NAME_LEN - 1)) j |= CS_CLOSE;
-		rw8_nvr(addr, *cptr++, j);
+	U8	n;
+	U8	f;
+
+	xq = get_xmodeq();
+	for(f=0; f<2; f++){
+		if(f == 0){
+			if(!(xq & MSCANM_XFLAG)) continue;
+			bid = bandid_m;
+		}else{
+			if(!(xq & MSCANS_XFLAG)) continue;
+			bid = bandid_s;
+		}
+		if((bid >= ID1200) || (scanix[bid] == 0)) continue;
+		j = mem[bid];
+		n = 0;
+		do{
+			if(++j >= MAX_MEM) j = 0;
+			if(scanix[bid] & (1L << j)){
+				if(mcache_find(bid, j) == MCACHE_LEN){
+					mcache_load(bid, j);				// one record per call
+					return;
+				}
+				n++;
+			}
+		}while((j != mem[bid]) && (n < MCACHE_AHEAD));
 	}
 	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// read_nvmem() read the vfo state from the nv memory space
+// pack_mem() serializes a mem record into rptr[MEM_LEN] (see MEMR_xxx)
+//	name is copied for MEM_NAME_LEN chrs
 //-----------------------------------------------------------------------------
-void read_nvmem(U8 band, U8 memnum){
-	// mem structure follows this format:
-	// VFO + OFFS + DPLX + CTCSS + SQ + VOL + XIT + RIT + BID + MEM_NAME_LEN
-	U32	addr;		// temps
+void pack_mem(U8* rptr, U32 vfo, U16 offs, U8 dplx, U8 ctcss, U8 sq, U8 xit, U8 rit, U8 bid, char* name){
 	U8	i;
-	U8	j;
-	char* cptr;
-
-	addr = mem_band[band] + (memnum * MEM_LEN);
-	j = CS_READ;
-	vfo_p[band].vfo = rw32_nvr(addr, 0, j|CS_OPEN);
-	vfo_p[band].offs = rw16_nvr(addr, 0, j);
-	vfo_p[band].dplx = rw8_nvr(addr, 0, j);
-	vfo_p[band].ctcss = rw8_nvr(addr, 0, j);
-	vfo_p[band].sq = rw8_nvr(addr, 0, j);
-	rw8_nvr(addr, 0, j);								// deprecated !!! this will be a recall of the spare: vfo_p[band].spare//
-	ux129_xit = rw8_nvr(addr, 0, j);
-	ux129_rit = rw8_nvr(addr, 0, j);
-//	band = rw8_nvr(addr, 0, j);
-	i = rw8_nvr(addr, 0, j);
-	cptr = memname[band];
+
+	put_le(&rptr[MEMR_VFO], vfo, 4);
+	put_le(&rptr[MEMR_OFFS], offs, 2);
+	rptr[MEMR_DPLX] = dplx;
+	rptr[MEMR_CTCSS] = ctcss;
+	rptr[MEMR_SQ] = sq;
+	rptr[MEMR_VOL] = 0;									// vol deprecated (vfo_p[band].vol now a spare) //
+	rptr[MEMR_XIT] = xit;
+	rptr[MEMR_RIT] = rit;
+	rptr[MEMR_BID] = bid;
 	for(i=0; i<MEM_NAME_LEN; i++){
-		if(i == (MEM_NAME_LEN - 1)) j |= CS_CLOSE;
-		*cptr++ = rw8_nvr(addr, 0, j);
+		rptr[MEMR_NAME + i] = (U8)*name++;
 	}
-	*cptr = '\0';
 	return;
 }
 
+//-----------------------------------------------------------------------------
+// put_le() stores len bytes of dataw at dptr, lsb first (NVRAM byte order)
+//-----------------------------------------------------------------------------
+void put_le(U8* dptr, U32 dataw, U8 len){
+
+	for( ; len; len--, dataw >>= 8){
+		*dptr++ = (U8)dataw;
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// get_le() returns the len byte value at sptr, lsb first (NVRAM byte order)
+//-----------------------------------------------------------------------------
+U32 get_le(U8* sptr, U8 len){
+	U32	ii = 0;
+
+	while(len){
+		ii = (ii << 8) | sptr[--len];
+	}
+	return ii;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// get_memaddr() returns the address of the mem#/band
+// get_memaddr() returns the address of the mem#/band (hot fields, MEMH_LEN bytes)
 //-----------------------------------------------------------------------------
 U32 get_memaddr(U8 band, U8 memnum){
 
-	return mem_band[band] + (memnum * MEM_LEN);
+	return mem_band[band] + (memnum * MEMH_LEN);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// get_mnameaddr() returns the address of the mem#/band name (MEM_NAME_LEN bytes)
+//-----------------------------------------------------------------------------
+U32 get_mnameaddr(U8 band, U8 memnum){
+
+	return MEMN_0 + (band * MEMN_BAND) + (memnum * MEM_NAME_LEN);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// nvr_write_mem() writes a packed mem record (see pack_mem()) to the mem#/band
+//-----------------------------------------------------------------------------
+void nvr_write_mem(U8 band, U8 memnum, U8* rec){
+
+	nvr_write_block(get_memaddr(band, memnum), rec, MEMH_LEN);
+	nvr_write_block(get_mnameaddr(band, memnum), &rec[MEMR_NAME], MEM_NAME_LEN);
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// nvr_read_mem() reads a packed mem record from the mem#/band.  len = MEMH_LEN
+//	reads just the hot fields, len = MEM_LEN also reads the name.
+//-----------------------------------------------------------------------------
+void nvr_read_mem(U8 band, U8 memnum, U8* rec, U8 len){
+
+	nvr_read_block(get_memaddr(band, memnum), rec, MEMH_LEN);
+	if(len > MEMH_LEN){
+		nvr_read_block(get_mnameaddr(band, memnum), &rec[MEMR_NAME], MEM_NAME_LEN);
+	}
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// nvram_fix() updates an out-of-version NVRAM layout to the current version.
+//	sn is the version SN read from the NVRAM.  Returns TRUE if the NVRAM was
+//	updated, FALSE if sn is not a known layout (caller re-inits the NVRAM).
+//
+//	NVSN_V1 -> NVSN_V2: the V1 mem segment (MEM_LEN records) is copied to NVMIG_0
+//	and the SN is set to NVSN_MIG.  The V2 hot/name regions are then rebuilt from
+//	the copy.  If power fails during the rebuild, the next IPL sees NVSN_MIG and
+//	rebuilds again from the copy.  The scan-enable index is always rebuilt from the
+//	new records: a block left at SCANIX_0 by an earlier V2 run (V2 -> V1 -> V2) has a
+//	good CRC, but holds stale scan bits.
+//-----------------------------------------------------------------------------
+U8 nvram_fix(U16 sn){
+	U8	rec[MEM_LEN];
+	U8	bid;
+	U8	j;
+	U32	addr;
+
+	if((sn != NVSN_V1) && (sn != NVSN_MIG)) return FALSE;
+	putsQ("NVRAM layout update...");					// display status msg to console
+	if(sn == NVSN_V1){
+		for(addr=MEM0_BASE; addr<MEM_END; addr+=MEM_LEN){
+			nvr_read_block(addr, rec, MEM_LEN);
+			nvr_write_block(addr - MEM0_BASE + NVMIG_0, rec, MEM_LEN);
+		}
+		nvsn_wr(NVSN_MIG);
+	}
+	addr = NVMIG_0;
+	for(bid=0; bid<ID1200; bid++){
+		for(j=0; j<NUM_MEMS; j++){
+			nvr_read_block(addr, rec, MEM_LEN);
+			nvr_write_mem(bid, j, rec);
+			addr += MEM_LEN;
+		}
+	}
+	mcache_inval(MCACHE_ALL, 0);						// drop any records cached before the rebuild
+	scanix_build();										// re-index from the new records
+	nvsn_wr(nvram_sn());
+	return TRUE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// nvsn_wr() writes the NVRAM version SN (user SN bytes 14-15)
+//-----------------------------------------------------------------------------
+void nvsn_wr(U16 sn){
+	U8	usnbuf[16];		// User SN buffer
+
+	rwusn_nvr(usnbuf, 0);
+	usnbuf[14] = (U8)sn;
+	usnbuf[15] = (U8)(sn >> 8);
+	rwusn_nvr(usnbuf, CS_WRITE);
+	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2389,20 +3014,20 @@ void set_bandid(U8 focus, U8 b_id){
 // get_nameptr() returns pointer to name string
 //-----------------------------------------------------------------------------
 char* get_nameptr(U8 focus){
-	char* nptr = memname[bandid_s];
 
-	if(focus == MAIN) nptr = memname[bandid_m];
-	return nptr;
+	if(focus == MAIN) return mname_get(bandid_m);
+	return mname_get(bandid_s);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// set_bandnv() writes the band ids to NV ram
+// set_bandnv() writes the band ids to NV ram (flushes the NVRAM cache)
 //-----------------------------------------------------------------------------
 void set_bandnv(void){
 
-	rw8_nvr(BIDM_0, bandid_m, CS_WRITE|CS_OPEN);
-	rw8_nvr(BIDM_0, bandid_s, CS_WRITE|CS_CLOSE);
+	nvc_wr(BIDM_0, bandid_m, 1);
+	nvc_wr(BIDS_0, bandid_s, 1);
+	nvc_flush(1);										// band change, write back now
 	return;
 }
 
@@ -2410,66 +3035,61 @@ void set_bandnv(void){
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// set_qnv() writes the squ to NV ram
+// set_qnv() writes the squ to the NVRAM cache
 //-----------------------------------------------------------------------------
 void set_qnv(U8 focus){
 	U8	i;		// temp
 
 	if(focus == MAIN) i = bandid_m;
 	else i = bandid_s;
-	rw8_nvr(SQ_0+((VFO_LEN * (U32)i) + VFO_0), vfo_p[i].sq, CS_WRITE|CS_OPENCLOSE);
+	nvc_wr(SQ_0+((VFO_LEN * (U32)i) + VFO_0), vfo_p[i].sq, 1);
 	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// set_vnv() writes the vol to NV ram
+// set_vnv() writes the vol to the NVRAM cache
 //-----------------------------------------------------------------------------
 void set_vnv(U8 focus){
 
 	if(focus == MAIN){
-		rw8_nvr(VOL_0 + VFO_0 + VFO_LEN, vol_m, CS_WRITE|CS_OPENCLOSE);
+		nvc_wr(VOL_0 + VFO_0 + VFO_LEN, vol_m, 1);
 	}else{
-		rw8_nvr(VOL_0 + VFO_0, vol_s, CS_WRITE|CS_OPENCLOSE);
+		nvc_wr(VOL_0 + VFO_0, vol_s, 1);
 	}
 	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// set_tonenv() writes the ctcss value to NV ram
+// set_tonenv() writes the ctcss value to the NVRAM cache
 //-----------------------------------------------------------------------------
 void set_tonenv(U8 focus){
 	U8	i;		// temp
 
 	if(focus == MAIN) i = bandid_m;
 	else i = bandid_s;
-	rw8_nvr(CTCSS_0+((VFO_LEN * (U32)i) + VFO_0), vfo_p[i].ctcss, CS_WRITE|CS_OPENCLOSE);
+	nvc_wr(CTCSS_0+((VFO_LEN * (U32)i) + VFO_0), vfo_p[i].ctcss, 1);
 	return;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// get_scanmem() reads scan enable bit from NV space
+// get_scanmem() returns the scan enable bit (SCANEN_F) of the current mem
 //-----------------------------------------------------------------------------
 U8 get_scanmem(U8 focus){
-	// mem structure follows this format:
-	// VFO + OFFS + DPLX + CTCSS + SQ + VOL + XIT + RIT + BID + MEM_NAME_LEN
-	U32	addr;		// temps
 	U8	i;
-	U8	j;
 
 	if(focus == MAIN) i = bandid_m;						// set main/sub index
 	else i = bandid_s;
-	addr = mem_band[i] + (mem[i] * MEM_LEN);			// calc base mem addr
-	addr += sizeof(U32) + sizeof(U16);					// point to duplex byte
-	j = rw8_nvr(addr, 0, CS_READ | CS_OPENCLOSE);		// read byte
-	return j & SCANEN_F;								// return masked bit
+	return get_scanen(i, mem[i]);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 //-----------------------------------------------------------------------------
-// get_scanen() reads scan enable bit from NV space
+// get_scanen() returns the scan enable bit (SCANEN_F) of a mem.  memnum >= MAX_MEM
+//	uses the current mem.  mems are looked up in the scan-enable index, call mems
+//	(not indexed) are read from NV space.
 //-----------------------------------------------------------------------------
 U8 get_scanen(U8 bid, U8 memnum){
 	// mem structure follows this format:
@@ -2480,8 +3100,11 @@ U8 get_scanen(U8 bid, U8 memnum){
 
 	if(memnum >= MAX_MEM) i = mem[bid];					// set main/sub index
 	else i = memnum;
-	addr = mem_band[bid] + (i * MEM_LEN);				// calc base mem addr
-	addr += sizeof(U32) + sizeof(U16);					// point to duplex byte
+	if(i < MAX_MEM){
+		if(scanix[bid] & (1L << i)) return SCANEN_F;
+		return 0;
+	}
+	addr = get_memaddr(bid, i) + MEMR_DPLX;				// point to duplex byte
 	j = rw8_nvr(addr, 0, CS_READ | CS_OPENCLOSE);		// read byte
 	return j & SCANEN_F;								// return masked bit
 }
@@ -2499,28 +3122,118 @@ U8 togg_scanmem(U8 focus){
 
 	if(focus == MAIN) i = bandid_m;						// set main/sub index
 	else i = bandid_s;
-	addr = mem_band[i] + (mem[i] * MEM_LEN);			// calc base mem addr
-	addr += sizeof(U32) + sizeof(U16);					// point to duplex byte
+	addr = get_memaddr(i, mem[i]) + MEMR_DPLX;			// point to duplex byte
 	j = rw8_nvr(addr, 0, CS_READ | CS_OPENCLOSE);		// read byte
 	j ^= SCANEN_F;										// invert scan bit
 	rw8_nvr(addr, j, CS_WRITE | CS_OPENCLOSE);			// write byte
+	mcache_inval(i, mem[i]);
+	scanix_upd(i, mem[i], j & SCANEN_F);
 	return j & SCANEN_F;								// return masked bit
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// scanix_load() reads the mem scan-enable index from NV space.  If it does not
+//	validate (first run, or it was never written), it is rebuilt from the mem records.
+//-----------------------------------------------------------------------------
+void scanix_load(void){
+	U8	buf[SCANIX_LEN];
+	U8	i;
+	U16	crc = SCANIX_SEED;
+
+	nvr_read_block(SCANIX_0, buf, SCANIX_LEN);
+	for(i=0; i<(ID1200 * sizeof(U32)); i++){
+		crc = calcrc(buf[i], crc);
+	}
+	if(crc != (U16)get_le(&buf[i], 2)){
+		putsQ("SCANIX rebuild");						// display status msg to console
+		scanix_build();
+		return;
+	}
+	for(i=0; i<ID1200; i++){
+		scanix[i] = get_le(&buf[i * sizeof(U32)], 4) & SCANIX_MASK;
+	}
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// scanix_build() rebuilds the mem scan-enable index from the mem records and saves it
+//-----------------------------------------------------------------------------
+void scanix_build(void){
+	U8	bid;
+	U8	j;
+
+	for(bid=0; bid<ID1200; bid++){
+		scanix[bid] = 0;
+		for(j=0; j<MAX_MEM; j++){
+			if(rw8_nvr(get_memaddr(bid, j) + MEMR_DPLX, 0, CS_READ | CS_OPENCLOSE) & SCANEN_F){
+				scanix[bid] |= 1L << j;
+			}
+		}
+	}
+	scanix_save();
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// scanix_save() writes the mem scan-enable index to NV space (one message)
+//-----------------------------------------------------------------------------
+void scanix_save(void){
+	U8	buf[SCANIX_LEN];
+	U8	i;
+	U16	crc = SCANIX_SEED;
+
+	for(i=0; i<ID1200; i++){
+		put_le(&buf[i * sizeof(U32)], scanix[i], 4);
+	}
+	for(i=0; i<(ID1200 * sizeof(U32)); i++){
+		crc = calcrc(buf[i], crc);
+	}
+	put_le(&buf[i], crc, 2);
+	nvr_write_block(SCANIX_0, buf, SCANIX_LEN);
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// scanix_upd() updates the scan-enable index for a mem write (en = SCANEN_F bit)
+//	the index is saved if the bit changed.  call mems are not indexed.
+//-----------------------------------------------------------------------------
+void scanix_upd(U8 bid, U8 memnum, U8 en){
+	U32	ii;
+
+	if((bid >= ID1200) || (memnum >= MAX_MEM)) return;
+	ii = scanix[bid];
+	if(en) ii |= 1L << memnum;
+	else ii &= ~(1L << memnum);
+	if(ii != scanix[bid]){
+		scanix[bid] = ii;
+		scanix_save();
+	}
+	return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//-----------------------------------------------------------------------------
+// get_scanix() returns the scan-enable bitmap for a band (bit n = mem n)
+//-----------------------------------------------------------------------------
+U32 get_scanix(U8 bid){
+
+	return scanix[bid];
+}
+
 //-----------------------------------------------------------------------------
 // get_srf() returns srf
 //-----------------------------------------------------------------------------
 U8 get_srf(U8 focus){
-	U32	ii;
 	U8	i;
 
 	if(focus){
-		// get main SRF
-		ii = sin_addr0 >> 23;								// isolate main and sub SRF
-		i = (U8)(ii & 0x0f) >> 1;
+		i = sin_field(SEV_SRFM) >> 1;						// get main SRF
 	}else{
-		ii = sin_addr0 >> 19;								// isolate main and sub SRF
-		i = (U8)(ii & 0x0f) >> 1;
+		i = sin_field(SEV_SRFS) >> 1;						// get sub SRF
 	}
 	return i;
 }
@@ -2529,15 +3242,11 @@ U8 get_srf(U8 focus){
 // get_cos() returns COS/PTT flags
 //-----------------------------------------------------------------------------
 U8 get_cos(void){
-	U32	ii;
 	U8	i;
 
-	// get main SRF
-	ii = sin_addr0 & (SIN_SQSA|SIN_SQSB);					// isolate main and sub SRF
-	ii >>= SIN_SQSB_bp;
-	i = (U8)ii;
-	ii = (sin_addr1 & SIN_SEND) >> (SIN_SEND_bp - 2);		// place PTT at b2
-	i |= (U8)ii;
+	i = sin_field(SEV_COSS);								// sub COS at b0
+	i |= sin_field(SEV_COSM) << 1;							// main COS at b1
+	i |= sin_field(SEV_PTT) << 2;							// place PTT at b2
 	return i;
 }
 
@@ -80,6 +80,15 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 #define	BIDS_0		(BIDM_0 + sizeof(U8))		// bandids reg
 #define	VFO_END		(BIDS_0 + sizeof(U8))		// start of next segment
 
+// VFO NVRAM write-back cache: a RAM image of VFO_0..VFO_END.  Each VFO record (and the
+//	xit/rit/bandid trailer) has a dirty bit, nvc_flush() writes back the bytes of the dirty
+//	records that differ from a shadow of the NVRAM contents.
+#define	NVC_LEN		(VFO_END - VFO_0)			// image size (bytes)
+#define	NVC_TRL		NUM_VFOS					// dirty bit of the xit/rit/bandid trailer
+#define	NVC_QUIET_MS	1500					// flush once writes have been quiet this long (ms)
+#define	NVC_MAX_MS		10000					// .. or once the oldest dirty data is this old (ms)
+#define	NVC_GAP			5						// merge changed spans closer than this (WRITE + 3 addr + 1)
+
 #define	XMODET_0	VFO_END						// xmode flags
 
 #define	TXULIM_0	(XMODET_0 + ((sizeof(U8) * ID1200)))	// TX upper limits (per band)
@@ -92,17 +101,67 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 					// VFO + OFFS + DPLX + CTCSS + SQ + VOL + XIT + RIT + BID + MEM_NAME_LEN
 #define	MEM_LEN		(sizeof(U32) + sizeof(U16) + (sizeof(U8) * 7) + MEM_NAME_LEN)
 #define	MEM_STR_ADDR	(sizeof(U32) + sizeof(U16) + (sizeof(U8) * 7))
+#define	MEMH_LEN	MEM_STR_ADDR				// "hot" part of a mem record (all but the name)
+// packed mem record (MEM_LEN bytes, multi-byte fields lsb first), byte offsets:
+#define	MEMR_VFO	0
+#define	MEMR_OFFS	4
+#define	MEMR_DPLX	6
+#define	MEMR_CTCSS	7
+#define	MEMR_SQ		8
+#define	MEMR_VOL	9							// deprecated (spare)
+#define	MEMR_XIT	10
+#define	MEMR_RIT	11
+#define	MEMR_BID	12
+#define	MEMR_NAME	MEM_STR_ADDR
 #define	NUM_MEMS	34							// 30 mems, + 4 call mems
 #define	MAX_MEM		30
 #define	CALL_MEM	30							// first call mem#
 
+// NVRAM layout versions (stored in the user SN, see nvram_sn())
+#define	NVSN_V1		0x0001						// mems stored as whole MEM_LEN records
+#define	NVSN_V2		0x0002						// mem hot fields and names in separate regions
+#define	NVSN_MIG	0x8002						// V1 -> V2 migration in progress (V1 mems copied to NVMIG_0)
+
+// mems (NVSN_V2): a dense array of MEMH_LEN records per band, followed by the
+//	names (MEM_NAME_LEN per mem) in the same band/mem order
 #define	ID10M_MEM	MEM0_BASE
-#define	ID6M_MEM	(ID10M_MEM + (NUM_MEMS * MEM_LEN))
-#define	ID2M_MEM	(ID6M_MEM + (NUM_MEMS * MEM_LEN))
-#define	ID220_MEM	(ID2M_MEM + (NUM_MEMS * MEM_LEN))
-#define	ID440_MEM	(ID220_MEM + (NUM_MEMS * MEM_LEN))
-#define	ID1200_MEM	(ID440_MEM + (NUM_MEMS * MEM_LEN))
-#define	MEM_END		(ID1200_MEM + (NUM_MEMS * MEM_LEN))
+#define	ID6M_MEM	(ID10M_MEM + (NUM_MEMS * MEMH_LEN))
+#define	ID2M_MEM	(ID6M_MEM + (NUM_MEMS * MEMH_LEN))
+#define	ID220_MEM	(ID2M_MEM + (NUM_MEMS * MEMH_LEN))
+#define	ID440_MEM	(ID220_MEM + (NUM_MEMS * MEMH_LEN))
+#define	ID1200_MEM	(ID440_MEM + (NUM_MEMS * MEMH_LEN))
+#define	MEMN_0		(ID1200_MEM + (NUM_MEMS * MEMH_LEN))	// mem names
+#define	MEMN_BAND	(NUM_MEMS * MEM_NAME_LEN)				// mem name bytes per band
+#define	MEM_END		(MEMN_0 + (ID1200 * MEMN_BAND))		// (same size as the V1 mem segment)
+
+// mem scan-enable index: a copy of the SCANEN_F bits of the mem records (one U32 per band,
+//	bit n = mem n, mems 0 to MAX_MEM-1) followed by a CRC16
+#define	SCANIX_0	MEM_END
+#define	SCANIX_LEN	((ID1200 * sizeof(U32)) + sizeof(U16))
+#define	SCANIX_END	(SCANIX_0 + SCANIX_LEN)		// start of next segment
+#define	SCANIX_SEED	0xffff						// crc seed (a zeroed block does not validate)
+#define	SCANIX_MASK	((1L << MAX_MEM) - 1)
+
+// layout migration scratch: a copy of the V1 mem segment (only used by nvram_fix())
+#define	NVMIG_0		SCANIX_END
+#define	NVMIG_END	(NVMIG_0 + (MEM_END - MEM0_BASE))
+
+// decoded mem record cache (scan channels are prefetched ahead of the scan step).  Holds
+//	the hot fields only, the name is read when it is displayed (see get_nameptr()).
+#define	MCACHE_LEN		8						// cache entries (round-robin replacement)
+#define	MCACHE_AHEAD	3						// enabled mems prefetched ahead of each scanning band
+#define	MCACHE_ALL		0xff					// mcache_inval() bid: invalidate all entries
+struct mcache_struct {
+	U32	vfo;
+	U16	offs;
+	U8	dplx;
+	U8	ctcss;
+	U8	sq;
+	U8	xit;
+	U8	rit;
+	U8	bid;								// tag: band id (MCACHE_ALL = empty)
+	U8	mem;								// tag: mem#
+};
 
 // CTCSS flags
 #define	CTCSS_MASK		0x3F				// tone code mask
@@ -151,6 +210,85 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 #define	SIN_VFOS_F		0x00020000L					// vfo change flag
 #define SIN_SINACTO_F	0x00040000L					// SIN timeout has occurred
 
+// SIN event field IDs (index into sin_fmap[])
+#define	SEV_PTT			0			// PTT (addr1)
+#define	SEV_COSM		1			// COS main (addr0)
+#define	SEV_COSS		2			// COS sub (addr0)
+#define	SEV_SRFM		3			// SRF main (addr0)
+#define	SEV_SRFS		4			// SRF sub (addr0)
+#define	SEV_DSQA		5			// tone detect main (addr1)
+#define	SEV_DSQB		6			// tone detect sub (addr1)
+#define	SEV_MCK			7			// MIC u/d button pressed (addr1)
+#define	SEV_MUP			8			// MIC u/d button state (addr1)
+#define	SEV_SEL			9			// OPT detect bits (addr1)
+#define	SEV_BUSY		10			// module selected feedback (addr0)
+#define	SEV_NUM			11			// number of mapped fields
+
+// SIN event consumer IDs (each has its own queue tail)
+#define	SEVC_UI			0			// lcd.c process_MS()
+#define	SEVC_SOUT		1			// process_SOUT() PTT detect
+#define	SEVC_MIC		2			// is_mic_updn()
+#define	SEVC_NUM		3
+
+#define	SIN_EVQ_MAX		32			// event queue length (must be power of 2)
+#define	SIN_EVQ_MASK	(SIN_EVQ_MAX - 1)
+
+// SIN event word: [15:8] = field ID, [7:0] = new field value
+#define	SEV_ID(e)		((U8)((e) >> 8))
+#define	SEV_VAL(e)		((U8)((e) & 0xff))
+
+// SIN field map entry
+struct sin_fmap_struct {
+	U8	addr;						// SIN address (0/1) that carries the field
+	U8	shift;						// right shift to justify the field
+	U32	mask;						// field mask (in SIN word position)
+};
+
+#define	SV_MAIN			0x01		// process_SOUT(): save main VFO after the burst
+#define	SV_SUB			0x02		// .. save sub VFO
+#define	XIT_CHUNK		4			// X/RIT pulses per SOUT sequence (8 frames, ~55ms)
+#define	PTTF_SENT		0x80		// ptt_fast: sequence sent by the PTT fast path
+#define	PTTF_IPRI		2			// Timer3B (PTT fast path) intr priority, below the SIN and SOUT intrs
+#define	PLL_SWEEP_CRC	0x4995		// pll_sweep() golden CRC (from host_test/pll_sweep_gen.c)
+
+// SOUT trace: every frame handed to the SOUT engine is logged with its (computed) wire start
+//	time, the request that caused it, and the SOUT request queue depth.  causes 0-7 are the
+//	SOUT_xxx_N ordinals.
+#define	SOTR_PTT		8			// PTT edge (process_SOUT())
+#define	SOTR_FPTT		9			// PTT edge (fast path)
+#define	SOTR_XIT		10			// X/RIT pulse chunk
+#define	SOTR_BOFF		11			// band module off
+#define	SOTR_MAX		64			// trace ring size (must be a power of 2)
+#define	SOTR_MASK		(SOTR_MAX - 1)
+struct sotr_struct {
+	U32	us;							// frame start (get_us())
+	U32	word;						// SOUT word
+	U8	cause;						// SOUT_xxx_N or SOTR_xxx
+	U8	depth;						// SOUT requests pending
+};
+// SOUT latency histograms (input event to first frame on the wire)
+#define	LAT_PTT			0			// SIN SEND edge -> first PTT frame
+#define	LAT_VFO			1			// dial step -> first PLL frame
+#define	LAT_VOL			2			// vol knob -> attenuator frame
+#define	LAT_NUM			3
+#define	LAT_BINS		16			// bin n counts latencies < (LAT_BIN0 << n) us, last bin is open
+#define	LAT_BIN0		128
+
+// setpll() frame cache entry (one each for main and sub)
+#define	PLLC_LEN	8				// max frames in one setpll() sequence (incl. end semaphore)
+struct pllc_struct {
+	U32	frm[PLLC_LEN];				// cached frame sequence
+	U32	trfrq;						// RX/TX frequency (KHz) of the sequence
+	U32	vfo;						// cache key: vfo
+	U16	offs;						// cache key: offset
+	U8	dplx;						// cache key: duplex/power flags
+	U8	bid;						// cache key: band ID (0xff = empty)
+	U8	is_tx;						// cache key: TX/RX
+	U8	otx_in;						// cache key: old_tx on entry
+	U8	otx;						// old_tx after the sequence
+	U8	len;						// frames stored (incl. end semaphore)
+};
+
 // SOUT signal flag bits
 #define SOUT_TONE_F		0x01	// tone update
 #define SOUT_TONE_N		0x00	// tone ordinal
@@ -167,7 +305,10 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 #define SOUT_VFOS_F		0x40	// sub vfo update
 #define SOUT_VFOS_N		0x06	// svfo ordinal
 #define SOUT_VFOM_F		0x80	// mvfo vfo update
-#define SOUT_VFOM_N		0x07	// tone ordinal
+#define SOUT_VFOM_N		0x07	// mvfo ordinal
+#define SOUT_NONE_N		0xff	// no request pending
+#define	SOUT_AGE_MAX	4		// services a request can wait before it is promoted
+#define	SOUT_PRIO_AGED	6		// priority of a promoted (aged) request
 
 #define	XPOLY	0x1021			// crc polynomial
 //#define	HIB_SEL	0
@@ -201,6 +342,15 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 #define	TS_125			(125/TS_PER)	// 125 KHz step
 #define	TS_MAX			(1000/TS_PER)	// 1000 KHz step
 
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+#ifndef SIN_EVT_C
+extern U32	sin_addr0;			// SIN data holding registers (sin_evt.c)
+extern U32	sin_addr1;
+#endif
+
 //-----------------------------------------------------------------------------
 // Global Fns
 //-----------------------------------------------------------------------------
@@ -208,17 +358,52 @@ enum vfos_enum{ vfoid, offsid, discid, lvlid };
 void init_radio(void);
 void process_SIN(U8 cmd);
 U8 process_SOUT(U8 cmd);
+void sout_seq_done(void);
+void ptt_seq_done(void);
+void xit_seq_start(U8 xreg);
+U8 xit_seq_next(void);
+void xit_seq_done(void);
+U8 get_xit_stat(U16* done, U8 clr);
+void sout_post(U8 flags);
+U8 sout_next(U8 value);
+U16 get_sout_coal(U8 clr);
+U8 sout_admit(void);
+U16 get_sout_bwdef(U8 clr);
+void lat_mark(U8 lclass, U32 t0);
+void sout_trace(U32* fptr, U8* cptr, U8 cause, U8 len);
+void sout_trace_dump(void);
+void lat_hist_dump(void);
+void clr_sout_trace(void);
 void save_vfo(U8 b_id);
 void nvwr_vfo(U8 startid, U8 stopid);
+void nvc_load(void);
+void nvc_wr(U32 addr, U32 dataw, U8 len);
+void nvc_flush(U8 force);
+void put_le(U8* dptr, U32 dataw, U8 len);
+U32 get_le(U8* sptr, U8 len);
+void pack_mem(U8* rptr, U32 vfo, U16 offs, U8 dplx, U8 ctcss, U8 sq, U8 xit, U8 rit, U8 bid, char* name);
 void recall_vfo(void);
 //U16 crc_vfo(void);
 U16 crc_hib(void);
 U16 calcrc(U8 c, U16 oldcrc);
 void push_vfo(void);
+U8 sin_word(U32 sin_data);
 U32 fetch_sin(U8 addr);
 U32 read_sin_flags(U32 flag);
+void init_sin_event(void);
+void post_sin_event(U8 id, U8 value);
+void sin_post_changes(U8 addr, U32 chg);
+U8 get_sin_event(U8 cons, U16* evptr);
+U8 sin_field(U8 id);
+U32 sin_event_flag(U16 ev);
+U16 get_sin_evor(U8 clr);
 void vfo_change(U8 band);
 U32* setpll(U8 bid, U32 *plldata, U8 is_tx, U8 is_main);
+U32* pll_frames(U8 bid, U32* plldata, U8 is_tx, U8 is_main, U8* otx, U32* trptr);
+U32* pll_build(U32 vfo, U16 offs, U8 dplx, U32* plldata, U8 is_tx, U8 is_main, U8* otx, U32* trptr);
+U8 ptt_cache_ok(void);
+void ptt_cache_build(void);
+U8 ptt_cache_get(U8 is_tx, U32* plldata);
 U8  get_present(void);
 //U32 set_squ(U8 mainsub);
 //U32 set_vol(U8 mainsub);
@@ -273,10 +458,21 @@ void set_tonenv(U8 focus);
 U8 get_scanmem(U8 focus);
 U8 get_scanen(U8 bid, U8 memnum);
 U8 togg_scanmem(U8 focus);
+void scanix_load(void);
+void scanix_upd(U8 bid, U8 memnum, U8 en);
+U32 get_scanix(U8 bid);
+void mcache_inval(U8 bid, U8 memnum);
+void mcache_prefetch(void);
 U32 get_memaddr(U8 band, U8 memnum);
+U32 get_mnameaddr(U8 band, U8 memnum);
+void nvr_write_mem(U8 band, U8 memnum, U8* rec);
+void nvr_read_mem(U8 band, U8 memnum, U8* rec, U8 len);
+U8 nvram_fix(U16 sn);
 void set_memnum(U8 bid, U8 memnum);
 U8  get_bflag(U8 focus, U8 cmd, U8 bfset);
 U8 get_modulid(U32 freqMM);
+U32 pll_sweep_pass(U16* crcp, void (*fn)(U8 bid, U32 f, U8 k, U32* fptr, U8 len));
+void pll_sweep(void);
 void copy_2vfo(U8 main, U32 vfod);
 U8 get_srf(U8 focus);
 U8 get_cos(void);
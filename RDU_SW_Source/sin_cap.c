@@ -0,0 +1,195 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: sin_cap.c
+ *
+ *  Module:    Control
+ *
+ *  Summary:
+ *  SIN capture/replay buffer.  Capture records every decoded SIN frame
+ *  (before duplicate screening, 0 = framing error) with its free_32 time
+ *  into sin_cap[].  Replay hands the captured frames back at the recorded
+ *  pacing.  The caller supplies the time (ms), so this file has no
+ *  hardware dependencies and can also be built on a host (see
+ *  host_test/sin_rply_test.c).  The on-target glue (get_sin()/got_sin(),
+ *  sin_replay(), sin_cap_dump()) is in sio.c.
+ *
+ *******************************************************************/
+
+#include "typedef.h"
+#include "init.h"						// App-specific SFR Definitions
+#include "sio.h"
+
+//-----------------------------------------------------------------------------
+// Local Variable Declarations
+//-----------------------------------------------------------------------------
+
+U32	sin_cap[SIN_CAP_MAX];				// captured SIN frames
+U32	sin_capts[SIN_CAP_MAX];				// capture times (free_32, ms)
+U16	sin_capw;							// capture write count (free-running)
+U8	sin_capmode;						// capture mode (SCAP_OFF, SCAP_ONE, SCAP_RUN)
+U8	sin_rply;							// true if replay is running
+U16	sin_rpidx;							// replay index
+U32	sin_rpt0;							// replay start time
+
+//-----------------------------------------------------------------------------
+// sin_cap_init() stops capture/replay and empties the capture buffer (IPL)
+//-----------------------------------------------------------------------------
+void sin_cap_init(void){
+
+	sin_capw = 0;
+	sin_capmode = SCAP_OFF;
+	sin_rply = 0;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_rec() records a decoded frame (0 = framing error) taken at time t if a
+//	capture is running.  Called from Timer2B_ISR().
+//-----------------------------------------------------------------------------
+void sin_cap_rec(U32 sdata, U32 t){
+
+	if(!sin_capmode) return;
+	if((sin_capmode == SCAP_RUN) || (sin_capw < SIN_CAP_MAX)){
+		sin_cap[sin_capw & SIN_CAP_MASK] = sdata;
+		sin_capts[sin_capw & SIN_CAP_MASK] = t;
+		sin_capw++;
+		if(sin_capw == 0) sin_capw = SIN_CAP_MAX;			// keep the full count on wrap
+	}else{
+		sin_capmode = SCAP_OFF;								// one-shot is full
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_mode() sets the capture mode:
+//	SCAP_OFF stops capture, SCAP_ONE captures until the buffer is full, SCAP_RUN
+//	captures continuously (oldest frames are overwritten).  Starting a capture
+//	clears the buffer.  A capture can't start while a replay is running.
+//-----------------------------------------------------------------------------
+void sin_cap_mode(U8 mode){
+
+	if(mode != SCAP_OFF){
+		if(sin_rply) return;
+		sin_capw = 0;
+	}
+	sin_capmode = mode;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_clr() stops capture and empties the capture buffer
+//-----------------------------------------------------------------------------
+void sin_cap_clr(void){
+
+	sin_capmode = SCAP_OFF;
+	sin_rply = 0;
+	sin_capw = 0;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_len() returns the # of frames in the capture buffer
+//-----------------------------------------------------------------------------
+U16 sin_cap_len(void){
+
+	if(sin_capw > SIN_CAP_MAX) return SIN_CAP_MAX;
+	return sin_capw;
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_get() returns capture entry "idx" (0 = oldest).  The frame time,
+//	relative to the first (oldest) frame, is returned at *dtptr.
+//-----------------------------------------------------------------------------
+U32 sin_cap_get(U16 idx, U32* dtptr){
+	U16	first;
+
+	first = sin_capw - sin_cap_len();
+	*dtptr = sin_capts[(first + idx) & SIN_CAP_MASK] - sin_capts[first & SIN_CAP_MASK];
+	return sin_cap[(first + idx) & SIN_CAP_MASK];
+}
+
+//-----------------------------------------------------------------------------
+// sin_cap_put() appends a frame to the capture buffer.  dt is the frame time
+//	relative to the first frame (used to load a recorded stream for replay).
+//	Returns FALSE if the buffer is full or a capture/replay is running.
+//-----------------------------------------------------------------------------
+char sin_cap_put(U32 dt, U32 sdata){
+	U16	i;
+
+	if(sin_capmode || sin_rply || (sin_capw >= SIN_CAP_MAX)) return FALSE;
+	i = sin_capw;
+	sin_cap[i] = sdata;
+	if(i) sin_capts[i] = sin_capts[0] + dt;
+	else sin_capts[i] = 0L;
+	sin_capw = i + 1;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_start() starts a replay of the capture buffer at time t (capture is
+//	stopped first).  Returns FALSE if the buffer is empty.
+//-----------------------------------------------------------------------------
+U8 sin_rply_start(U32 t){
+
+	sin_capmode = SCAP_OFF;
+	if(!sin_cap_len()) return FALSE;
+	sin_rpidx = 0;
+	sin_rpt0 = t;
+	sin_rply = 1;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_stop() stops a replay.  Returns TRUE if one was running.
+//-----------------------------------------------------------------------------
+U8 sin_rply_stop(void){
+
+	sin_capmode = SCAP_OFF;
+	if(!sin_rply) return FALSE;
+	sin_rply = 0;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_on() returns TRUE if a replay is running
+//-----------------------------------------------------------------------------
+U8 sin_rply_on(void){
+
+	return sin_rply;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_end() returns TRUE if all frames of the replay have been taken
+//-----------------------------------------------------------------------------
+U8 sin_rply_end(void){
+
+	if(sin_rpidx >= sin_cap_len()) return TRUE;
+	return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_due() returns TRUE if the next replay frame is due at time t
+//-----------------------------------------------------------------------------
+U8 sin_rply_due(U32 t){
+	U32	dt;
+
+	if(sin_rply_end()) return FALSE;
+	sin_cap_get(sin_rpidx, &dt);
+	if((t - sin_rpt0) >= dt) return TRUE;
+	return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_rply_next() returns the next replay frame if it is due at time t, else 0.
+//	The frame's lateness (ms past its recorded time) is returned at *ageptr.
+//-----------------------------------------------------------------------------
+U32 sin_rply_next(U32 t, U32* ageptr){
+	U32	ii;
+	U32	dt;
+
+	if(!sin_rply_due(t)) return 0L;
+	ii = sin_cap_get(sin_rpidx++, &dt);
+	*ageptr = t - sin_rpt0 - dt;
+	return ii;
+}
@@ -0,0 +1,115 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: sin_dec.c
+ *
+ *  Module:    Control
+ *
+ *  Summary:
+ *  SIN frame decode from Timer2A edge timestamps and SEND edge detect.
+ *  This file has no hardware dependencies so that it can also be built
+ *  on a host (see host_test/sin_dec_test.c and sin_rply_test.c).
+ *
+ *******************************************************************/
+
+#include "typedef.h"
+#include "init.h"						// App-specific SFR Definitions
+#include "sio.h"
+
+//-----------------------------------------------------------------------------
+// Local Variable Declarations
+//-----------------------------------------------------------------------------
+
+volatile U8	sin_send;					// SEND (PTT) state of the latest addr 1 frame (PTT fast path edge detect)
+
+//-----------------------------------------------------------------------------
+// sin_decode() rebuilds a SIN word from a list of edge timestamps
+//	eptr[0] is the start bit falling edge, each following edge toggles the line.
+//	Each bit is evaluated at three points: mid-bit (the same point the bit sampler
+//	used) and SIN_VOTE_TIME either side of it.  If vote == 0, the mid-bit sample
+//	sets the bit; else the 2-of-3 majority does.  The # of bits with disagreeing
+//	samples is returned at *gptr.  Returns the SIN word (with stop bits set) or 0
+//	if the frame has a framing error.
+//	Timestamps are from a down-counting 24b timer.
+//-----------------------------------------------------------------------------
+U32 sin_decode(U32* eptr, U8 ecount, U8 vote, U8* gptr){
+	U32	t0;						// start edge time
+	U32	tsamp;					// sample point, relative to t0
+	U32	dr = 0L;				// data reg
+	U32	mask = SIN_START;		// data mask
+	U8	level = 0;				// line level (low after the start edge)
+	U8	j = 1;					// edge index
+	U8	k;						// sample index
+	U8	ones;					// # samples == 1 for this bit
+	U8	b;						// bit value
+
+	*gptr = 0;
+	if((ecount == 0) || (ecount > SIN_EDGE_MAX)){
+		return 0L;
+	}
+	t0 = eptr[0];
+	tsamp = SIN_HALF_BIT_TIME - SIN_VOTE_TIME;
+	do{
+		ones = 0;
+		b = 0;
+		for(k=0; k<3; k++){
+			// apply all edges that happened before this sample point
+			while((j < ecount) && (((t0 - eptr[j]) & SIN_TSTAMP_MASK) < tsamp)){
+				level ^= 1;
+				j++;
+			}
+			ones += level;
+			if(k == 1) b = level;						// mid-bit sample
+			tsamp += SIN_VOTE_TIME;
+		}
+		tsamp += SIN_BIT_TIME - (3 * SIN_VOTE_TIME);	// next bit
+		if((ones != 0) && (ones != 3)) *gptr += 1;		// samples disagree, count a glitch
+		if(vote) b = (ones >= 2);
+		if(mask == SIN_START){
+			if(b){
+				return 0L;								// framing error if data == 1 here
+			}
+		}else{
+			if(b){
+				dr |= mask;								// capture a 1
+			}
+		}
+		mask >>= 1;
+	}while(mask != 0x2000L);
+	return dr | 0x3fffL;								// set stop bits
+}
+
+//-----------------------------------------------------------------------------
+// sin_start_ok() checks the width of the start bit.  t0 is the start (falling) edge,
+//	t1 is the next edge.  A real start bit holds the line low past the mid-bit
+//	sample point, a shorter pulse is a false start (glitch).  Returns TRUE if the
+//	start bit is valid.
+//	Timestamps are from a down-counting 24b timer.
+//-----------------------------------------------------------------------------
+U8 sin_start_ok(U32 t0, U32 t1){
+
+	if(((t0 - t1) & SIN_TSTAMP_MASK) < SIN_START_MIN) return FALSE;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_send_edge() checks a SIN frame for a SEND (PTT) edge.  Only addr 1 frames
+//	with valid stop bits carry SEND (the same frames that process_SIN() takes).  The
+//	state of the latest one is kept in sin_send, which is not cleared by sin_refresh()
+//	(a re-sync can't fake an edge).  Returns TRUE on an edge.
+//-----------------------------------------------------------------------------
+U8 sin_send_edge(U32 sdata){
+
+	if((sdata & (SIN_ADDR | SIN_STOP)) != (SIN_ADDR | SIN_STOP)) return FALSE;
+	if(((sdata & SIN_SEND) ? 1 : 0) == sin_send) return FALSE;
+	sin_send ^= 1;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// get_sin_send() returns the SEND (PTT) state of the latest SIN addr 1 frame
+//-----------------------------------------------------------------------------
+U8 get_sin_send(void){
+
+	return sin_send;
+}
@@ -0,0 +1,179 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: sin_evt.c
+ *
+ *  Module:    Control
+ *
+ *  Summary:
+ *  SIN word holding registers, field map, and change event queue (the
+ *  sin_flags logic of process_SIN()).  This file has no hardware
+ *  dependencies so that it can also be built on a host (see
+ *  host_test/sin_rply_test.c).
+ *
+ *******************************************************************/
+
+#define SIN_EVT_C
+#include "typedef.h"
+#include "init.h"						// App-specific SFR Definitions
+#include "sio.h"
+#include "radio.h"
+
+//-----------------------------------------------------------------------------
+// Local Variable Declarations
+//-----------------------------------------------------------------------------
+
+U32	sin_addr0;							// holding registers for SIN data (addr 1 and 0)
+U32	sin_addr1;
+
+// SIN field map: one entry per SEV_xxx ID.  sin_word() walks this table to
+//	turn SIN word changes into events; sin_field() uses it to extract values.
+const struct sin_fmap_struct sin_fmap[SEV_NUM] = {
+//	 addr	shift			mask
+	{ 1,	SIN_SEND_bp,	SIN_SEND },			// SEV_PTT
+	{ 0,	28,				SIN_SQSA },			// SEV_COSM
+	{ 0,	SIN_SQSB_bp,	SIN_SQSB },			// SEV_COSS
+	{ 0,	23,				SIN_SRFA },			// SEV_SRFM
+	{ 0,	19,				SIN_SRFB },			// SEV_SRFS
+	{ 1,	28,				SIN_DSQA },			// SEV_DSQA
+	{ 1,	27,				SIN_DSQB },			// SEV_DSQB
+	{ 1,	26,				SIN_MCK },			// SEV_MCK
+	{ 1,	25,				SIN_MUP },			// SEV_MUP
+	{ 1,	20,				SIN_SEL11|SIN_SEL12|SIN_SEL21|SIN_SEL22 },	// SEV_SEL
+	{ 0,	29,				SIN_BUSY }			// SEV_BUSY
+};
+
+U16	sin_evq[SIN_EVQ_MAX];				// SIN event queue (broadcast to all consumers)
+U8	sin_evh;							// event queue head (free-running)
+U8	sin_evt[SEVC_NUM];					// per-consumer tails (free-running)
+U16	sin_evor;							// event overrun count (oldest events dropped)
+
+//-----------------------------------------------------------------------------
+// sin_word() takes a SIN frame.  If the extended "stop" bits are valid, the frame is
+//	stored in the holding register for its address and an event is posted for each
+//	mapped field that changed (repeats post nothing).  Returns FALSE if the stop bits
+//	are not valid (the frame is ignored).
+//-----------------------------------------------------------------------------
+U8 sin_word(U32 sin_data){
+	U32	ii;
+
+	if((sin_data & SIN_STOP) != SIN_STOP) return FALSE;
+	if(sin_data & SIN_ADDR){							// process addr == 1 data
+		if(sin_data != sin_addr1){						// if data is new (different == new)
+			ii = sin_data ^ sin_addr1;
+			sin_addr1 = sin_data;						// store new data
+			sin_post_changes(1, ii);
+		}
+	}else{
+		if(sin_data != sin_addr0){						// process addr == 0 data
+			ii = sin_data ^ sin_addr0;
+			sin_addr0 = sin_data;
+			sin_post_changes(0, ii);
+		}
+	}
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// fetch_sin() returns the last valid SIN data based on the address param
+//	used to transfer local data to other source domains
+//-----------------------------------------------------------------------------
+U32  fetch_sin(U8 addr){
+	U32	ii;
+
+	if(addr) ii = sin_addr1;
+	else ii = sin_addr0;
+	return ii;
+}
+
+//-----------------------------------------------------------------------------
+// init_sin_event() resets the SIN event queue
+//-----------------------------------------------------------------------------
+void init_sin_event(void){
+	U8	i;
+
+	sin_evh = 0;
+	for(i=0; i<SEVC_NUM; i++){
+		sin_evt[i] = 0;
+	}
+	sin_evor = 0;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// post_sin_event() adds a field change event to the SIN event queue
+//	if a consumer has fallen a full queue behind, its oldest event is dropped
+//-----------------------------------------------------------------------------
+void post_sin_event(U8 id, U8 value){
+	U8	i;
+
+	for(i=0; i<SEVC_NUM; i++){
+		if((U8)(sin_evh - sin_evt[i]) >= SIN_EVQ_MAX){
+			sin_evt[i]++;								// consumer is full, drop oldest
+			sin_evor++;
+		}
+	}
+	sin_evq[sin_evh & SIN_EVQ_MASK] = ((U16)id << 8) | (U16)value;
+	sin_evh++;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// get_sin_event() pulls the next event for consumer "cons"
+//	returns TRUE with the event at *evptr, or FALSE if the queue is empty
+//-----------------------------------------------------------------------------
+U8 get_sin_event(U8 cons, U16* evptr){
+
+	if(sin_evt[cons] == sin_evh) return FALSE;
+	*evptr = sin_evq[sin_evt[cons] & SIN_EVQ_MASK];
+	sin_evt[cons]++;
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// sin_post_changes() posts an event for each mapped field that changed
+//	in the SIN word at "addr".  chg is the XOR of the old and new words.
+//-----------------------------------------------------------------------------
+void sin_post_changes(U8 addr, U32 chg){
+	U8	i;
+
+	for(i=0; i<SEV_NUM; i++){
+		if((sin_fmap[i].addr == addr) && (chg & sin_fmap[i].mask)){
+			post_sin_event(i, sin_field(i));
+		}
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_field() returns the current (right justified) value of a SIN field
+//-----------------------------------------------------------------------------
+U8 sin_field(U8 id){
+	U32	ii;
+
+	if(sin_fmap[id].addr) ii = sin_addr1;
+	else ii = sin_addr0;
+	return (U8)((ii & sin_fmap[id].mask) >> sin_fmap[id].shift);
+}
+
+//-----------------------------------------------------------------------------
+// sin_event_flag() returns the legacy SIN_xxx_F change flag for an event
+//	(addr0 fields sit in the low half of sin_flags, addr1 in the high half)
+//-----------------------------------------------------------------------------
+U32 sin_event_flag(U16 ev){
+	U8	i = SEV_ID(ev);
+
+	if(i >= SEV_NUM) return 0;
+	if(sin_fmap[i].addr) return sin_fmap[i].mask;
+	return sin_fmap[i].mask >> 16;
+}
+
+//-----------------------------------------------------------------------------
+// get_sin_evor() returns the SIN event overrun count, clears if clr == TRUE
+//-----------------------------------------------------------------------------
+U16 get_sin_evor(U8 clr){
+	U16	i = sin_evor;
+
+	if(clr) sin_evor = 0;
+	return i;
+}
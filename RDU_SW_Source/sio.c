@@ -32,15 +32,58 @@
 // local declarations
 //-----------------------------------------------------------------------------
 
-U32	sin_perr;
-U8	sin_error;
-U32	sin_mask;
-U8	sin_hptrm1;
-U8	sin_hptr;
-U8	sin_tptr;
-#define	SIN_MAX	10
+// SIN frame ring: single producer (Timer2B_ISR) and single consumer (get_sin()).  The head and
+//	tail indexes free-run (U8) and are masked on access, so SIN_MAX must be a power of 2.  Only
+//	the ISR writes sin_hptr and only get_sin()/flush_sin() write sin_tptr.
+#define	SIN_MAX		16
+#define	SIN_MASK	(SIN_MAX - 1)
+#define	SIN_DMB		__asm(" dmb")		// data memory barrier, orders buffer vs. index accesses
+#define	SOUT_LOCK(pm)	pm = int_lock()		// mask intrs (send_so_seq() can be entered from the PTT fast path ISR)
+#define	SOUT_UNLOCK(pm)	int_unlock(pm)		// .. restores the entry PRIMASK (safe inside ISRs and nested locks)
+
+U32	sin_perr;							// dropped frame (overrun) count
+U8	sin_error;							// framing error count
+volatile U8	sin_hptr;					// ring head (producer)
+volatile U8	sin_tptr;					// ring tail (consumer)
+U8	sin_hwm;							// ring high-water mark
 U32	sin_buf[SIN_MAX];
-U32	sin_dr;
+U32	sin_ts[SIN_MAX];					// frame arrival times (free_32, ms)
+U32	sin_age;							// age of the last frame taken from the ring (ms)
+U32	sin_agemax;							// max age seen
+// SIN mailboxes: latest word and last-seen time for each SIN address (0 and 1).  The ISR only
+//	queues a frame if it differs from the mailbox for its address.  A mailbox value of 0 is
+//	"empty" (a decoded word always has the stop bits set) and forces the next frame through.
+U32	sin_mbox[2];
+U32	sin_mbts[2];
+U32	sin_dups;							// duplicate frame count (not queued)
+// SOUT bus budget: frames started per bin over a SOUT_BW_BINS bin sliding window.  Only the
+//	engine owner (inside send_so_seq()) or a SOUT_LOCK holder touches these.
+U16	sout_bwbin[SOUT_BW_BINS];
+U8	sout_bwidx;							// current bin
+U32	sout_bwt;							// start time of the current bin (ms)
+U8	sout_bwpk;							// peak utilization (%)
+U32	sin_sendus;							// time of the latest SEND edge (us, get_us())
+// SIN link quality: each bit is sampled 3x, sin_vote selects mid-bit or 2-of-3 majority
+U8	sin_vote;							// 0 = mid-bit sample, 1 = majority vote
+U32	sin_frames;							// decoded frame count (good + framing errors)
+U32	sin_gframes;						// frames with at least one glitched bit
+U32	sin_gbits;							// glitched bit count (samples disagree)
+
+// local Fn declarations
+void sout_bw_roll(void);
+U8 sout_bw_util(void);
+char rply_rdy(void);
+U32 rply_get(void);
+U32	sin_edge[SIN_EDGE_MAX];			// SIN edge timestamps for the current frame (Timer2A capture)
+U8	sin_ecount;						// # edges captured in the current frame
+U8	sin_sync;						// true if the next edge is a rising edge that must be dropped
+// SOUT sequence engine: uDMA control table (primary structures only, must be 1024 byte aligned),
+//	the formatted SSI1 transfers for the active sequence, and the completion callback.
+#pragma DATA_ALIGN(udma_ctl, 1024)
+U32	udma_ctl[128];
+U16	sout_seq[SOUT_SEQ_MAX * SOUT_SSI_PER_FRAME];
+void (*sout_done_fn)(void);
+volatile U8	sout_busy;					// true while a sequence is in flight
 
 //-----------------------------------------------------------------------------
 // ***** START OF CODE *****
@@ -51,27 +94,49 @@ U32	sin_dr;
  */
 U32 init_sio(void)
 {
-	U32				j;				// temp U32
 	U32				iplr = 0;
 	volatile U32	ui32Loop;
 
 	// init local variables
 	sin_error = 0;
 	sin_perr = 0;
-	sin_mask = 0;
-	sin_hptrm1 = 0;
+	sin_ecount = 0;
+	sin_sync = 0;
 	sin_hptr = 0;
 	sin_tptr = 0;
+	sin_hwm = 0;
+	sin_age = 0;
+	sin_agemax = 0;
+	sin_dups = 0;
+	sin_vote = SIN_VOTE_DFLT;
+	sin_frames = 0;
+	sin_gframes = 0;
+	sin_gbits = 0;
+	sin_cap_init();
+	sin_refresh();
+	sin_mbts[0] = 0;
+	sin_mbts[1] = 0;
 	sin_buf[sin_hptr] = 0;
 
-	// init ssi1 (4800 baud, 32b, async serial out)
-	// with 32 bits (2, 16bit values written into the FIFO one after the other), the SO bitmap is as follows
+	// init WTimer5A (32b, prescaled to 1us, free-running down counter) as the SOUT trace/latency timebase
+	SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R5;
+	ui32Loop = SYSCTL_RCGCWTIMER_R;
+	WTIMER5_CTL_R &= ~(TIMER_CTL_TAEN);									// disable timer
+	WTIMER5_CFG_R = TIMER_CFG_16_BIT;									// split (32b A)
+	WTIMER5_TAMR_R = TIMER_TAMR_TAMR_PERIOD;							// periodic, count down (prescaler is a true prescaler)
+	WTIMER5_TAPR_R = US_TIMER_PS;
+	WTIMER5_TAILR_R = 0xffffffffL;
+	WTIMER5_IMR_R = 0;													// no intr
+	WTIMER5_CTL_R |= (TIMER_CTL_TAEN);
+
+	// init ssi1 (4800 baud, 33b, async serial out)
+	// with 33 bits (3, 11bit values written into the FIFO one after the other), the SO bitmap is as follows
 	//	BIT#		DESCRIPTION
-	//	31			start, always cleared to 0
-	//	[30:28]		addr
-	//	[27:21]		control
-	//	[20:01]		data
-	//	00			stop, always set to 1 -- really need 2 stop bits, but this will have to be enforced at the next level up
+	//	32			start, always cleared to 0
+	//	[31:29]		addr
+	//	[28:22]		control
+	//	[21:02]		data
+	//	[01:00]		stop, always set to 1 (2 stop bits, so frames may be sent back-to-back)
 
 	// SOUT config
 	SYSCTL_RCGCSSI_R |= SYSCTL_RCGCSSI_R1;
@@ -86,33 +151,51 @@ U32 init_sio(void)
 	// SCR = (SYSCLK/(BR * CPSDVSR)) - 1
 	// see SSICLK_calc.xls for minimum error values for CPSDVSR and SCR
 	SSI1_CPSR_R = SSI1_CPSDVSR;
-	SSI1_CR0_R = (SSI1_SCR << 8) | SSI_CR0_DSS_16 | SSI_CR0_SPO | SSI_CR0_FRF_TI;		// bit rate, clock ph/pol, #bits
+	SSI1_CR0_R = (SSI1_SCR << 8) | SSI_CR0_DSS_11 | SSI_CR0_SPO | SSI_CR0_FRF_TI;		// bit rate, clock ph/pol, #bits
 	SSI1_CC_R = 0;														// SYSCLK is the clk reference for SSI1
-	SSI1_CR1_R = SSI_CR1_SSE;											// enable SSI
+	SSI1_IM_R = 0;														// TX (EOT) intr is enabled per sequence
+	SSI1_DMACTL_R = SSI_DMACTL_TXDMAE;									// TX FIFO drives uDMA requests
+	SSI1_CR1_R = SSI_CR1_EOT;											// TXRIS = end of transmission
+	SSI1_CR1_R = SSI_CR1_EOT | SSI_CR1_SSE;								// enable SSI
 	// SIN config
-	j = GPIO_PORTF_IM_R;												// disable SIN edge intr
-	GPIO_PORTF_IM_R = 0x00;
-	GPIO_PORTF_IEV_R &= ~SIN_TTL;										// falling edge
-	GPIO_PORTF_IBE_R &= ~SIN_TTL;										// one edge
-	GPIO_PORTF_IS_R &= ~SIN_TTL;										// edge ints
-	GPIO_PORTF_ICR_R = 0xff;											// clear int flags
-	j |= (SIN_TTL);														// enable SIN edge intr
-	GPIO_PORTF_IM_R = j;
-	GPIO_PORTF_IM_R |= (SIN_TTL);										// enable SIN edge intr
-
-	// init Timer2A (Count dn, periodic -- inputs IC-900 async data)
+	GPIO_PORTF_IM_R &= ~(SIN_TTL);										// no GPIO edge intr, SIN is a timer CCP input
+	GPIO_PORTF_AFSEL_R |= SIN_TTL;										// enable alt fn (T2CCP0)
+	GPIO_PORTF_PCTL_R &= ~(GPIO_PCTL_PF4_M);
+	GPIO_PORTF_PCTL_R |= (GPIO_PCTL_PF4_T2CCP0);
+	GPIO_PORTF_ICR_R = (SIN_TTL);										// clear int flags
+
+	// init Timer2A (24b edge-time capture, both edges -- timestamps IC-900 async data edges)
+	//	Timer2B (one-shot, no GPIO) closes the frame window SIN_FRAME_TIME after the start edge
 	SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
 	ui32Loop = SYSCTL_RCGCGPIO_R;
-	TIMER2_CTL_R &= ~(TIMER_CTL_TAEN);									// disable timer
+	TIMER2_CTL_R &= ~(TIMER_CTL_TAEN|TIMER_CTL_TBEN);					// disable timers
 	TIMER2_CFG_R = TIMER_CFG_16_BIT; //0x4; //0;
-	TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
-	TIMER2_TAPR_R = TIMER2A_PS;
-	TIMER2_TAILR_R = (uint16_t)(SIN_BIT_TIME);
-	TIMER2_IMR_R = TIMER_IMR_TATOIM;									// enable timer intr
-//	TIMER2_CTL_R |= (TIMER_CTL_TAEN);									// enable timer
+	TIMER2_TAMR_R = TIMER_TAMR_TAMR_CAP | TIMER_TAMR_TACMR;				// edge-time capture, count down
+	TIMER2_CTL_R |= TIMER_CTL_TAEVENT_BOTH;								// capture both edges
+	TIMER2_TAPR_R = TIMER2A_CAP_PS;
+	TIMER2_TAILR_R = 0xffff;
+	TIMER2_TBMR_R = TIMER_TBMR_TBMR_1_SHOT;
+	TIMER2_TBPR_R = TIMER2B_PS;
+	TIMER2_TBILR_R = (uint16_t)(SIN_FRAME_TIME);
+	TIMER2_IMR_R = TIMER_IMR_CAEIM | TIMER_IMR_TBTOIM;					// enable capture and frame-end intr
 	TIMER2_ICR_R = TIMER2_MIS_R;										// clear any flagged ints
+	TIMER2_CTL_R |= (TIMER_CTL_TAEN);									// enable capture timer
 	NVIC_EN0_R = NVIC_EN0_TIMER2A;										// enable timer2A intr in the NVIC_EN regs
-	NVIC_EN0_R = NVIC_EN0_GPIOF;										// enable GPIOF edge intr in the NVIC_EN regs
+	NVIC_EN0_R = NVIC_EN0_TIMER2B;										// enable timer2B intr in the NVIC_EN regs
+
+	// init SOUT sequence engine (uDMA ch25 fed by the SSI1 TX FIFO, see send_so_seq())
+	sout_busy = 0;
+	sout_done_fn = 0;
+	SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+	ui32Loop = SYSCTL_RCGCDMA_R;
+	UDMA_CFG_R = UDMA_CFG_MASTEN;										// enable uDMA controller
+	UDMA_CTLBASE_R = (U32)udma_ctl;
+	UDMA_CHMAP3_R = (UDMA_CHMAP3_R & ~UDMA_CHMAP3_CH25SEL_M) | (SOUT_DMA_ENC << UDMA_CHMAP3_CH25SEL_S);
+	UDMA_PRIOCLR_R = 1L << SOUT_DMA_CH;									// default priority
+	UDMA_ALTCLR_R = 1L << SOUT_DMA_CH;									// primary control structure
+	UDMA_USEBURSTCLR_R = 1L << SOUT_DMA_CH;								// respond to single and burst requests
+	UDMA_REQMASKCLR_R = 1L << SOUT_DMA_CH;								// allow SSI1 TX requests
+	NVIC_EN1_R = NVIC_EN1_SSI1;											// enable SSI1 intr in the NVIC_EN regs
 	iplr = IPL_ASIOINIT;
 
 	return iplr;
@@ -120,7 +203,7 @@ U32 init_sio(void)
 
 //**********************************************************************************************//
 //																								//
-//	Serial Out via SSI1TX to create a 4800 baud, 32b data path (1 start bit, 1 stop bit)		//
+//	Serial Out via SSI1TX to create a 4800 baud, 33b data path (1 start bit, 2 stop bits)		//
 //	Requires an inverter to get it to work right since the TIVA SPI returns to zero between		//
 //	transfers.																					//
 //																								//
@@ -128,45 +211,211 @@ U32 init_sio(void)
 
 /****************
  * send_so sends 4800 baud ASYNC data using SSI1 tx output
- * 	data is 30 bits, right justified. send_so() adds the start and stop bits, and then stores
- * 	the transfer as two 16 bit values to the SPI data register/FIFO
+ * 	data is 30 bits, right justified.  The word is sent as a one frame sequence, so it never
+ * 	waits on the SSI.  returns FALSE (not sent) if a sequence is still in flight.
  */
-void send_so(uint32_t data)
+U8 send_so(uint32_t data)
+{
+	U32	ii = (U32)data;
+
+	return send_so_seq(&ii, 1, 0);
+}
+
+/****************
+ * so_format adds the start and 2 stop bits to a SOUT word and stores it as the three inverted
+ * 	11 bit values that feed the SSI
+ */
+void so_format(uint32_t data, uint16_t* dptr)
 {
 	uint32_t i2;
-	uint16_t ii;
-	uint16_t jj;
 
-	i2 = ((data << 1) | 0x0001L) & 0x7fffffffL;				// add start and stop bits
-	if(SSI1_SR_R & SSI_SR_BSY){								// wait for previous msg to clear
-		wait(!(SSI1_SR_R & SSI_SR_BSY));
-//		wait(2);											// add extra time to complete 2nd stop bit
+	i2 = ((data << 1) | 0x0001L) & 0x7fffffffL;				// add start and 1st stop bits
+	*dptr++ = ~(uint16_t)(i2 >> 21) & 0x07ff;				// invert & break 33 bit data into 3 11 bit..
+	*dptr++ = ~(uint16_t)(i2 >> 10) & 0x07ff;				// .. pieces to feed the 11 bit SSI
+	*dptr = ~(uint16_t)((i2 << 1) | 0x0001L) & 0x07ff;		// 2nd stop bit is the last bit
+	return;
+}
+
+/****************
+ * int_lock masks intrs and returns the PRIMASK value from before the mask (the
+ *	TivaWare CPUcpsid() form: the result is left in r0 and the fn returns from the asm)
+ */
+U32 int_lock(void)
+{
+	__asm("    mrs     r0, PRIMASK\n"
+		  "    cpsid   i\n"
+		  "    bx      lr\n");
+	return 0;												// (not reached, keeps the compiler happy)
+}
+
+/****************
+ * int_unlock restores the intr mask saved by int_lock().  Intrs are only re-enabled if
+ *	they were enabled when the lock was taken.
+ */
+void int_unlock(U32 pm)
+{
+
+	if(!(pm & 0x01)) __asm(" cpsie i");
+	return;
+}
+
+/****************
+ * send_so_seq hands a list of SOUT words to the uDMA engine.  The SSI1 TX FIFO requests the
+ * 	transfers, so the frames go out back-to-back with exactly 2 stop bits between them.  fn() is
+ * 	called from SSI1_ISR() at the SSI end-of-transmission (after the last 2nd stop bit).
+ * 	returns FALSE if the engine is busy or len is out of range.
+ */
+U8 send_so_seq(U32* fptr, U8 len, void (*fn)(void))
+{
+	U8	i;
+	U16	n = (U16)len * SOUT_SSI_PER_FRAME;
+	U32* cptr = &udma_ctl[SOUT_DMA_CH * 4];
+	U32	pm;		// PRIMASK at entry
+
+	if((len == 0) || (len > SOUT_SEQ_MAX)) return FALSE;
+	SOUT_LOCK(pm);											// claim the engine (main loop vs. PTT fast path)
+	if(sout_busy){
+		SOUT_UNLOCK(pm);
+		return FALSE;
+	}
+	sout_busy = 1;
+	sout_bw_roll();											// update the bus budget
+	sout_bwbin[sout_bwidx] += len;
+	i = sout_bw_util();
+	if(i > sout_bwpk) sout_bwpk = i;
+	SOUT_UNLOCK(pm);
+	for(i=0; i<len; i++){
+		so_format(fptr[i], &sout_seq[i * SOUT_SSI_PER_FRAME]);	// build SSI transfers
+	}
+	sout_done_fn = fn;
+	*cptr++ = (U32)&sout_seq[n - 1];						// src end ptr
+	*cptr++ = (U32)&SSI1_DR_R;								// dest end ptr
+	*cptr = UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCINC_16 | UDMA_CHCTL_SRCSIZE_16 |
+			UDMA_CHCTL_ARBSIZE_4 | ((U32)(n - 1) << 4) | UDMA_CHCTL_XFERMODE_BASIC;
+	UDMA_ENASET_R = 1L << SOUT_DMA_CH;						// SSI1 TX FIFO requests start the transfer
+	return TRUE;
+}
+
+/****************
+ * sout_bw_roll advances the SOUT budget window to the current time, clearing expired bins.
+ * 	call with SOUT_LOCK held.
+ */
+void sout_bw_roll(void)
+{
+	U8	i;
+	U32	t = get_free();
+
+	if((t - sout_bwt) >= (SOUT_BW_BINMS * SOUT_BW_BINS)){
+		for(i=0; i<SOUT_BW_BINS; i++){
+			sout_bwbin[i] = 0;								// idle for a whole window
+		}
+		sout_bwt = t;
+	}else{
+		while((t - sout_bwt) >= SOUT_BW_BINMS){
+			sout_bwidx = (sout_bwidx + 1) & (SOUT_BW_BINS - 1);
+			sout_bwbin[sout_bwidx] = 0;
+			sout_bwt += SOUT_BW_BINMS;
+		}
 	}
-	ii = ~(uint16_t)(i2 >> 16);								// invert & break 32 bit data into 2 16 bit..
-	jj = ~(uint16_t)(i2 & 0xffff);							// .. pieces to feed the 16 bit SSI
-	SSI1_DR_R = ii;
-	SSI1_DR_R = jj;
 	return;
 }
 
+/****************
+ * sout_bw_util returns the SOUT bus utilization (%) over the budget window.  call with SOUT_LOCK held.
+ */
+U8 sout_bw_util(void)
+{
+	U8	i;
+	U16	n = 0;
+
+	for(i=0; i<SOUT_BW_BINS; i++){
+		n += sout_bwbin[i];
+	}
+	if(n > SOUT_BW_CAP) n = SOUT_BW_CAP;					// a burst is binned when it starts
+	return (U8)((n * 100L) / SOUT_BW_CAP);
+}
+
+/****************
+ * get_sout_util returns the SOUT bus utilization (%) over the last SOUT_BW_BINS * SOUT_BW_BINMS ms
+ */
+U8 get_sout_util(void)
+{
+	U8	i;
+	U32	pm;		// PRIMASK at entry
+
+	SOUT_LOCK(pm);
+	sout_bw_roll();
+	i = sout_bw_util();
+	SOUT_UNLOCK(pm);
+	return i;
+}
+
+/****************
+ * get_sout_peak returns the peak SOUT bus utilization (%), clears if clr == TRUE
+ */
+U8 get_sout_peak(U8 clr)
+{
+	U8	i = sout_bwpk;
+
+	if(clr) sout_bwpk = 0;
+	return i;
+}
+
+/****************
+ * get_us returns the free-running microsecond timebase (WTimer5A, wraps every 71 min)
+ */
+U32 get_us(void)
+{
+
+	return ~WTIMER5_TAR_R;
+}
+
+/****************
+ * get_sin_sendus returns the time (us) of the latest SIN SEND edge
+ */
+U32 get_sin_sendus(void)
+{
+
+	return sin_sendus;
+}
+
+/****************
+ * sout_seq_busy returns true if a SOUT sequence is in flight
+ */
+U8 sout_seq_busy(void)
+{
+
+	return sout_busy;
+}
+
 //**********************************************************************************************//
 //																								//
-//	Serial IN via PF4 & timer2a to create a 4800 baud, 31b data path (1 start bit, 16 stop bit)	//
+//	Serial IN via PF4 & timer2 to create a 4800 baud, 31b data path (1 start bit, 16 stop bit)	//
+//	Timer2A timestamps each SIN edge (T2CCP0 edge-time capture).  Timer2B closes the frame		//
+//	window and the frame is rebuilt from the edge times in one pass.							//
 //																								//
 //**********************************************************************************************//
 
 //-----------------------------------------------------------------------------
 // get_sin looks for chr in input buffer.  If none, return '\0'
-//	uses circular buffer sin_buf[] which is filled in the TIMER2A interrupt
+//	uses circular buffer sin_buf[] which is filled in the TIMER2B interrupt
+//	also updates the frame age stats from the frame timestamp
 //-----------------------------------------------------------------------------
 U32 get_sin(void){
 	U32 c = 0L;
+	U8	t;
 
-	if(sin_tptr != sin_hptr){						// if head != tail,
-		c = sin_buf[sin_tptr++];					// get chr from circ-buff and update tail ptr
-		if(sin_tptr >= SIN_MAX){					// process tail wrap-around
-			sin_tptr = 0;
-		}
+	if(sin_rply_on()){
+		return rply_get();							// replay has the input
+	}
+	t = sin_tptr;
+	if(t != sin_hptr){								// if head != tail,
+		SIN_DMB;									// read head before the data it covers
+		c = sin_buf[t & SIN_MASK];					// get chr from circ-buff
+		sin_age = get_free() - sin_ts[t & SIN_MASK];
+		if(sin_age > sin_agemax) sin_agemax = sin_age;
+		SIN_DMB;									// finish the reads before releasing the slot
+		sin_tptr = t + 1;							// update tail ptr
 	}
 	return c;
 }
@@ -177,6 +426,9 @@ U32 get_sin(void){
 char got_sin(void){
 	char c = FALSE;			// return val, default to "no chr"
 
+	if(sin_rply_on()){
+		return rply_rdy();							// replay has the input
+	}
     if(sin_tptr != sin_hptr){						// if (head != tail) && there is at least 1 msg..
     	c = TRUE;									// .. set chr ready to get flag
 	}
@@ -189,19 +441,42 @@ char got_sin(void){
 void flush_sin(void){
 	U8	i;	// temp
 
-	GPIO_PORTF_IM_R &= ~(SIN_TTL);					// disable SIN edge and timer intr
-	TIMER2_CTL_R &= ~(TIMER_CTL_TAEN);
+	TIMER2_IMR_R &= ~(TIMER_IMR_CAEIM|TIMER_IMR_TBTOIM);	// disable SIN capture and frame intr
+	TIMER2_CTL_R &= ~(TIMER_CTL_TBEN);
 	for(i=0; i<SIN_MAX; i++){						// clear buffer entries
 		sin_buf[i] = 0;
 	}
-	sin_hptr = 0;
-	sin_hptrm1 = 0;
 	sin_tptr = sin_hptr;							// make tail == head,
-	GPIO_PORTF_ICR_R = (SIN_TTL);					// clear int flags
-	GPIO_PORTF_IM_R |= (SIN_TTL);					// enable SIN edge intr
+	sin_refresh();									// next frame of each addr gets queued
+	sin_ecount = 0;									// re-sync edge capture to the line state
+	if(GPIO_PORTF_DATA_R & SIN_TTL) sin_sync = 0;
+	else sin_sync = 1;
+	TIMER2_ICR_R = (TIMER_ICR_CAECINT|TIMER_ICR_TBTOCINT);	// clear int flags
+	TIMER2_IMR_R |= (TIMER_IMR_CAEIM|TIMER_IMR_TBTOIM);		// enable SIN capture and frame intr
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_refresh() empties the SIN mailboxes so that the next frame for each
+//	address is queued, even if it matches the last one (use this when the
+//	caller needs to see fresh frames, e.g., after a module select)
+//-----------------------------------------------------------------------------
+void sin_refresh(void){
+
+	sin_mbox[0] = 0L;
+	sin_mbox[1] = 0L;
 	return;
 }
 
+//-----------------------------------------------------------------------------
+// get_sin_seen() returns the time (ms) since a frame was last seen at addr
+//	(including duplicates that were not queued)
+//-----------------------------------------------------------------------------
+U32 get_sin_seen(U8 addr){
+
+	return get_free() - sin_mbts[addr & 0x01];
+}
+
 //-----------------------------------------------------------------------------
 // get_error() returns framing error count
 //-----------------------------------------------------------------------------
@@ -210,48 +485,191 @@ U32 get_error(void){
 	return sin_perr;
 }
 
+//-----------------------------------------------------------------------------
+// get_sin_hwm() returns ring high-water mark (max frames waiting)
+//-----------------------------------------------------------------------------
+U8 get_sin_hwm(void){
+
+	return sin_hwm;
+}
+
+//-----------------------------------------------------------------------------
+// get_sin_age() returns age (ms) of the last frame taken from the ring
+//-----------------------------------------------------------------------------
+U32 get_sin_age(void){
+
+	return sin_age;
+}
+
+//-----------------------------------------------------------------------------
+// set_sin_vote() selects SIN bit sampling: 0 = mid-bit, 1 = 3x majority vote
+//-----------------------------------------------------------------------------
+void set_sin_vote(U8 mode){
+
+	sin_vote = mode;
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// get_sin_lq() returns SIN link quality, the % of frames received without
+//	a glitch or framing error (100 if no frames yet)
+//-----------------------------------------------------------------------------
+U8 get_sin_lq(void){
+	U32	ii;
+
+	if(sin_frames == 0) return 100;
+	ii = sin_gframes + (U32)sin_error;
+	if(ii > sin_frames) ii = sin_frames;
+	return (U8)(((sin_frames - ii) * 100L) / sin_frames);
+}
+
 //-----------------------------------------------------------------------------
 // print_ptr() prints t/h ptrs
 //-----------------------------------------------------------------------------
 void print_ptr(void){
 	char dbuf[25];
 
-	sprintf(dbuf,"h%d,t%d", sin_hptr, sin_tptr);
+	sprintf(dbuf,"h%d,t%d", sin_hptr & SIN_MASK, sin_tptr & SIN_MASK);
+	putsQ(dbuf);
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// print_sin_stat() prints SIN ring telemetry
+//	clr != 0 clears the hwm, drop, framing error, and age stats after printing
+//-----------------------------------------------------------------------------
+void print_sin_stat(U8 clr){
+	char dbuf[50];
+
+	sprintf(dbuf,"SIN ring: %d/%d, hwm %d", (U8)(sin_hptr - sin_tptr), SIN_MAX, sin_hwm);
+	putsQ(dbuf);
+	sprintf(dbuf,"drops %u, ferrs %u, dups %u", sin_perr, sin_error, sin_dups);
+	putsQ(dbuf);
+	sprintf(dbuf,"age %u ms, max %u ms", sin_age, sin_agemax);
 	putsQ(dbuf);
+	sprintf(dbuf,"vote %d, frames %u, glitch %u (%u bits)", sin_vote, sin_frames, sin_gframes, sin_gbits);
+	putsQ(dbuf);
+	sprintf(dbuf,"LQ %d%%", get_sin_lq());
+	putsQ(dbuf);
+	if(clr){
+		sin_hwm = 0;
+		sin_perr = 0;
+		sin_error = 0;
+		sin_agemax = 0;
+		sin_dups = 0;
+		sin_frames = 0;
+		sin_gframes = 0;
+		sin_gbits = 0;
+	}
+	return;
+}
+
+//**********************************************************************************************//
+//																								//
+//	SIN capture/replay.  Capture records every decoded SIN frame (before duplicate screening,	//
+//	0 = framing error) with its free_32 time into sin_cap[] (sin_cap.c).  Replay feeds the		//
+//	captured frames back out of get_sin()/got_sin() at the recorded pacing so that process_SIN()	//
+//	and the sin_flags logic in radio.c run exactly as they would on live data.  Replayed addr 1	//
+//	SEND edges also pend the PTT fast path (Timer3B_ISR()), as live ones do.					//
+//																								//
+//**********************************************************************************************//
+
+//-----------------------------------------------------------------------------
+// sin_cap_dump() lists the capture buffer to the CLI as "<dt ms> <word>" lines
+//	(dt is decimal, relative to the first frame, word is hex).  The lines are
+//	in the same format that the CLI uses to load a stream for replay.
+//-----------------------------------------------------------------------------
+void sin_cap_dump(void){
+	char	dbuf[30];
+	U16		i;
+	U16		n;
+	U32		ii;
+	U32		dt;
+
+	n = sin_cap_len();
+	sprintf(dbuf,"SCAP n=%d", n);
+	putsQ(dbuf);
+	for(i=0; i<n; i++){
+		ii = sin_cap_get(i, &dt);
+		sprintf(dbuf,"%u %08x", dt, ii);
+		putsQ(dbuf);
+	}
+	putsQ("SCAP end");
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sin_replay() starts (tf != 0) or stops a replay of the capture buffer
+//	capture is stopped first.  When the replay ends, flush_sin() re-syncs to
+//	the live SIN data.
+//-----------------------------------------------------------------------------
+void sin_replay(U8 tf){
+
+	if(tf){
+		sin_rply_start(get_free());
+	}else{
+		if(sin_rply_stop()) flush_sin();
+	}
 	return;
 }
 
+//-----------------------------------------------------------------------------
+// rply_rdy() returns TRUE if the next replay frame is due.  Ends the replay
+//	at the end of the buffer.
+//-----------------------------------------------------------------------------
+char rply_rdy(void){
+
+	if(sin_rply_end()){
+		sin_replay(0);									// end of replay
+		return FALSE;
+	}
+	return sin_rply_due(get_free());
+}
+
+//-----------------------------------------------------------------------------
+// rply_get() returns the next replay frame and keeps the activity timer alive.
+//	A SEND edge pends the PTT fast path (the SIN ISR skips edge detect while a
+//	replay owns the input, so live and replayed edges don't mix).
+//-----------------------------------------------------------------------------
+U32 rply_get(void){
+	U32	ii = 0L;
+
+	if(rply_rdy()){
+		ii = sin_rply_next(get_free(), &sin_age);
+		if(sin_send_edge(ii)){
+			sin_sendus = get_us();
+			NVIC_SW_TRIG_R = INT_TIMER3B - 16;
+		}
+		sin_time(SIN_ACTIVITY);
+	}
+	return ii;
+}
+
 //-----------------------------------------------------------------------------
 // gpiof_isr
 //-----------------------------------------------------------------------------
 //
-// GPIO_PORTf isr, processes the SIN start bit detect
-//		starts timer2 at half bit time, and inits SIN process flags
+// GPIO_PORTf isr, SIN start bit detect is now handled by the Timer2A capture.
+//		This just clears any stray flags.
 //
 
 void gpiof_isr(void){
-	if(GPIO_PORTF_MIS_R & (SIN_TTL)){
-		GPIO_PORTF_ICR_R = (SIN_TTL);						// clear int flags
-		GPIO_PORTF_IM_R &= ~(SIN_TTL);						// disable SIN edge intr
-		sin_dr = 0x00000000L;								// init data reg and mask
-		sin_mask = SIN_START;
-		TIMER2_TAILR_R = (uint16_t)(SIN_HALF_BIT_TIME);
-		TIMER2_CTL_R |= (TIMER_CTL_TAEN);					// enable timer
-	}else{
-		GPIO_PORTF_ICR_R = 0xff;
-	}
+
+	GPIO_PORTF_ICR_R = 0xff;
 	return;
 }
 
 //-----------------------------------------------------------------------------
-// Timer2_ISR
+// Timer2A_ISR
 //-----------------------------------------------------------------------------
 //
-// Called when timer2A overflows:
-//	This ISR times one bit time at 4800 baud (1/2 bit time for start bit, this
-//	aligns the ISR to the center of the bit time).  Bits are shifted in from PF4
-//	until the mask == 0, at which point the data is transfered to the input buffer,
-//	and the GPIO isr is enabled to arm for the next start bit.
+// Called on each SIN edge (Timer2A edge-time capture event):
+//	The ISR just stores the edge timestamp.  The first edge of a frame (the start
+//	bit) also starts the Timer2B frame window.  If the start bit is too short
+//	(sin_start_ok()), the window is closed and the ISR re-arms for the next start
+//	bit right away.  If the line was held low at the
+//	end of the last window, the rising edge that releases it is dropped so that
+//	the next stored edge is a start bit.
 //
 //-----------------------------------------------------------------------------
 
@@ -259,44 +677,120 @@ void Timer2A_ISR(void)
 {
 	U32	i;		// temp
 
-	if(sin_hptr >= SIN_MAX){									// failsafe countermeasure
-		sin_hptr = 0;
-		sin_hptrm1 = 0;
-		sin_buf[sin_hptr] = 0;
-	}
-	if(TIMER2_MIS_R & TIMER_MIS_TATOMIS){
-		TIMER2_TAILR_R = (uint16_t)(SIN_BIT_TIME);
-		if(sin_mask == SIN_START){
-			if(GPIO_PORTF_DATA_R & SIN_TTL){
-				// framing error if data == 1 here
-				TIMER2_CTL_R &= ~(TIMER_CTL_TAEN);				// disable timer
-				GPIO_PORTF_ICR_R = (SIN_TTL);					// clear int flags
-				GPIO_PORTF_IM_R |= (SIN_TTL);					// enable SIN edge intr
+	if(TIMER2_MIS_R & TIMER_MIS_CAEMIS){
+		TIMER2_ICR_R = TIMER_ICR_CAECINT;						// clear capture intr
+		i = TIMER2_TAR_R;										// get edge timestamp
+		if(sin_sync){
+			sin_sync = 0;										// drop the line release edge
+		}else{
+			if(sin_ecount == 0){
+				TIMER2_TBILR_R = (uint16_t)(SIN_FRAME_TIME);	// start of frame, open the frame window
+				TIMER2_CTL_R |= (TIMER_CTL_TBEN);
+			}
+			if((sin_ecount == 1) && !sin_start_ok(sin_edge[0], i)){
+				TIMER2_CTL_R &= ~(TIMER_CTL_TBEN);				// false start, close the frame window
+				TIMER2_ICR_R = TIMER_ICR_TBTOCINT;
+				sin_ecount = 0;									// .. and re-arm for the next start bit
 				if(sin_error < 250) sin_error += 1;				// increment framing error count
 			}else{
-				sin_mask >>= 1;									// signal start of data capture
+				if(sin_ecount < SIN_EDGE_MAX){
+					sin_edge[sin_ecount] = i;
+				}
+				if(sin_ecount < 0xff) sin_ecount += 1;			// count > SIN_EDGE_MAX is a framing error
 			}
-		}else{
-			if(GPIO_PORTF_DATA_R & SIN_TTL){
-				sin_dr |= sin_mask;								// capture a 1
+		}
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// Timer2B_ISR
+//-----------------------------------------------------------------------------
+//
+// Called when the timer2B one-shot expires (end of SIN frame window):
+//	Rebuilds the frame from the captured edges (updating the glitch stats) and transfers the data to the
+//	input ring with a timestamp.  Only frames that differ from the mailbox for
+//	their address are queued, repeats just update the last-seen time.  If the
+//	ring is full, the new frame is dropped and counted (the consumer owns the
+//	tail, so the ISR never moves it).  An odd edge count means the line is still low, so the next
+//	(rising) edge is flagged to be dropped.  A change of the addr 1 SEND bit software-triggers the
+//	Timer3B intr (PTT fast path, see Timer3B_ISR() in radio.c).
+//
+//-----------------------------------------------------------------------------
+
+void Timer2B_ISR(void)
+{
+	U32	i;		// temp
+	U8	n;		// edge count/ring depth
+	U8	h;		// ring head
+	U8	a;		// SIN addr
+	U8	g;		// glitch count
+
+	TIMER2_ICR_R = TIMER_ICR_TBTOCINT;							// clear frame intr
+	n = sin_ecount;
+	i = sin_decode(sin_edge, n, sin_vote, &g);
+	sin_frames++;
+	if(g){
+		sin_gframes++;											// update glitch stats
+		sin_gbits += g;
+	}
+	sin_cap_rec(i, get_free());									// capture raw frame (if on)
+	if(n & 0x01) sin_sync = 1;									// line is low, drop the next edge
+	sin_ecount = 0;												// re-arm for next start bit
+	if(i){
+		a = (i & SIN_ADDR) ? 1 : 0;
+		sin_mbts[a] = get_free();								// mark addr as seen
+		if(!sin_rply_on()){										// replay owns get_sin(), live frames are not queued
+			if(sin_send_edge(i)){
+				sin_sendus = get_us();							// SEND edge, pend the PTT fast path (Timer3B_ISR)
+				NVIC_SW_TRIG_R = INT_TIMER3B - 16;
 			}
-			sin_mask >>= 1;
-			if(sin_mask == 0x2000L){
-				i = sin_dr | 0x3fffL;							// set data for storage
-//				if(sin_buf[sin_hptrm1] != i){					// if new data is different from last word, store it
-					sin_buf[sin_hptr++] = i;
-					if(sin_hptr >= SIN_MAX) sin_hptr = 0;
-					if(sin_hptr == sin_tptr) sin_perr++;
-//					sin_hptrm1++;
-//					if(sin_hptrm1 >= SIN_MAX) sin_hptrm1 = 0;
-//				}
-				sin_time(SIN_ACTIVITY);							// reset activity timer
-				TIMER2_CTL_R &= ~(TIMER_CTL_TAEN);				// disable timer
-				GPIO_PORTF_ICR_R = (SIN_TTL);					// clear int flags
-				GPIO_PORTF_IM_R |= (SIN_TTL);					// enable SIN edge intr
+			if(i != sin_mbox[a]){								// if new data is different from last word, store it
+				sin_mbox[a] = i;
+				h = sin_hptr;
+				n = (U8)(h - sin_tptr) + 1;						// ring depth including this frame
+				if(n <= SIN_MAX){
+					sin_buf[h & SIN_MASK] = i;
+					sin_ts[h & SIN_MASK] = sin_mbts[a];
+					SIN_DMB;									// data must land before the head moves
+					sin_hptr = h + 1;
+					if(n > sin_hwm) sin_hwm = n;
+				}else{
+					sin_perr++;									// ring full, drop this frame
+					sin_mbox[a] = 0L;							// .. and make sure the next one gets through
+				}
+			}else{
+				sin_dups++;
 			}
 		}
+		sin_time(SIN_ACTIVITY);									// reset activity timer (dups count as activity)
+	}else{
+		if(sin_error < 250) sin_error += 1;						// increment framing error count
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// SSI1_ISR
+//-----------------------------------------------------------------------------
+//
+// SOUT sequence engine:
+//	uDMA done means the last SOUT frame has been loaded into the SSI1 FIFO.  The TX intr is then
+//	enabled and, with SSI_CR1_EOT set, it fires when the FIFO is empty and the last bit (the
+//	2nd stop bit) has shifted out.  The sequence is then done and the done Fn is called.
+//
+//-----------------------------------------------------------------------------
+
+void SSI1_ISR(void){
+
+	if(UDMA_CHIS_R & (1L << SOUT_DMA_CH)){
+		UDMA_CHIS_R = 1L << SOUT_DMA_CH;					// clear uDMA done
+		SSI1_IM_R = SSI_IM_TXIM;							// wait for end of transmission
+	}
+	if(SSI1_MIS_R & SSI_MIS_TXMIS){
+		SSI1_IM_R = 0;										// sequence done
+		sout_busy = 0;
+		if(sout_done_fn) (*sout_done_fn)();
 	}
-	TIMER2_ICR_R = TIMERA_MIS_MASK;								// clear all A-intr
 	return;
 }
@@ -78,19 +78,63 @@
 #define SIN_SEL22	0x00100000L
 #define SIN1_DATA	(SIN_SEND|SIN_DSQA|SIN_DSQB|SIN_MCK|SIN_MUP|SIN_SEL11|SIN_SEL12|SIN_SEL21|SIN_SEL22)	// mask
 
+// SIN capture modes
+#define	SCAP_OFF	0			// capture off
+#define	SCAP_ONE	1			// capture until full
+#define	SCAP_RUN	2			// capture continuously (overwrite oldest)
+#define	SIN_CAP_MAX		128		// capture buffer length (must be a power of 2)
+#define	SIN_CAP_MASK	(SIN_CAP_MAX - 1)
+
 //-----------------------------------------------------------------------------
 // Global Fns
 //-----------------------------------------------------------------------------
 
 U32 init_sio(void);
-void send_so(uint32_t data);
+U8 send_so(uint32_t data);
+void so_format(uint32_t data, uint16_t* dptr);
+U32 int_lock(void);
+void int_unlock(U32 pm);
+U8 send_so_seq(U32* fptr, U8 len, void (*fn)(void));
+U8 sout_seq_busy(void);
+U8 get_sin_send(void);
+U32 get_us(void);
+U32 get_sin_sendus(void);
+U8 get_sout_util(void);
+U8 get_sout_peak(U8 clr);
 
 U32 get_sin(void);
 char got_sin(void);
 void flush_sin(void);
+void sin_refresh(void);
+U32 get_sin_seen(U8 addr);
 U32 get_error(void);
+U8 get_sin_hwm(void);
+U32 get_sin_age(void);
 void print_ptr(void);
+void print_sin_stat(U8 clr);
+U32 sin_decode(U32* eptr, U8 ecount, U8 vote, U8* gptr);
+U8 sin_start_ok(U32 t0, U32 t1);
+U8 sin_send_edge(U32 sdata);
+void set_sin_vote(U8 mode);
+U8 get_sin_lq(void);
+void sin_cap_init(void);
+void sin_cap_rec(U32 sdata, U32 t);
+void sin_cap_mode(U8 mode);
+void sin_cap_clr(void);
+U16 sin_cap_len(void);
+U32 sin_cap_get(U16 idx, U32* dtptr);
+char sin_cap_put(U32 dt, U32 sdata);
+U8 sin_rply_start(U32 t);
+U8 sin_rply_stop(void);
+U8 sin_rply_on(void);
+U8 sin_rply_end(void);
+U8 sin_rply_due(U32 t);
+U32 sin_rply_next(U32 t, U32* ageptr);
+void sin_cap_dump(void);
+void sin_replay(U8 tf);
 void gpiof_isr(void);
 void Timer2A_ISR(void);
+void Timer2B_ISR(void);
+void SSI1_ISR(void);
 
 #endif /* SPI_H_ */
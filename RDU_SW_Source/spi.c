@@ -22,26 +22,51 @@
 #include "spi.h"
 #include "lcd.h"
 #include "serial.h"
+#include "sio.h"
 
 // ******************************************************************
 // defines
 
 	volatile	U8	ssiflag;			// clock edge trigger (if == 1), set by Timer1B ISR
+// NVRAM SSI: SCK/MOSI (PD0/PD3) are SSI3 pins, but MISO shares PB2 with the LOCK switch and
+//	PB2 has no SSI Rx function.  So NVRAM writes (cmds, addresses, and data) go out through the
+//	SSI3 TX FIFO, and NVRAM reads are shifted in by nvr_get() with the pins switched back to GPIO.
+//	The pins are only on SSI3 while RAMCS_N is low, the LCD bit-bang uses them as GPIO.
+	U8	nvr_ssi;						// true if PD0/PD3 are switched to SSI3
+	U32	nvr_closeus;					// time RAMCS_N was raised (us), LOCK sw settling
 
 // declarations
 U8 shift_spi(U8 dato);
 void open_nvr(void);
+void nvr_pins(U8 ssi);
+void nvr_put(U8 dato);
+U8 nvr_get(U8 dato);
+void nvr_wait_us(U32 us);
 
 // ******************************************************************
 // ***** START OF CODE ***** //
 /****************
- * init_spi3 initializes bit-bang QSSI
+ * init_spi3 initializes bit-bang QSSI and the NVRAM SSI (SSI3)
+ *	The NVRAM is SPI mode 3 (SPO=1/SPH=1), but SCK is inverted on the way to the
+ *	slave devices (MOSI is not), so SSI3 uses SPO=0/SPH=1.
  */
 void init_spi3(void)
 {
+	volatile uint32_t ui32Loop;
 
 	ssiflag = 0;									// init volatiles
 //	TIMER1_IMR_R |= TIMER_IMR_TBTOIM;				// enable timer intr
+	SYSCTL_RCGCSSI_R |= SYSCTL_RCGCSSI_R3;
+	ui32Loop = SYSCTL_RCGCSSI_R;
+	GPIO_PORTD_PCTL_R &= ~(GPIO_PCTL_PD0_M | GPIO_PCTL_PD3_M);		// PCTL only applies while AFSEL is set (see nvr_pins())
+	GPIO_PORTD_PCTL_R |= (GPIO_PCTL_PD0_SSI3CLK | GPIO_PCTL_PD3_SSI3TX);
+	SSI3_CR1_R = 0;									// disable SSI before configuring
+	SSI3_CPSR_R = NVR_CPSDVSR;
+	SSI3_CR0_R = (NVR_SCR << 8) | SSI_CR0_DSS_8 | SSI_CR0_SPH | SSI_CR0_FRF_MOTO;	// bit rate, clock ph/pol, #bits
+	SSI3_CC_R = 0;									// SYSCLK is the clk reference for SSI3
+	SSI3_CR1_R = SSI_CR1_SSE;						// enable SSI
+	nvr_ssi = 0;									// pins start as GPIO (bit-bang)
+	nvr_closeus = 0;
 	return;
 }
 
@@ -200,10 +225,7 @@ void open_nvr(void)
 {
 
 //	putchar_bQ('c');
-	TIMER1_CTL_R |= (TIMER_CTL_TBEN);					// enable bit timer
-	GPIO_PORTD_DATA_R &= ~RAMCS_N;						// open NVRAM
-	ssiflag = 0;
-	while(!ssiflag);									// sync to bit timer ISR & setup time
+	GPIO_PORTD_DATA_R &= ~RAMCS_N;						// open NVRAM (PB2 is now MISO)
 	return;
 }
 
@@ -212,15 +234,98 @@ void open_nvr(void)
  */
 void close_nvr(void)
 {
+	volatile U32	di;
 
-	GPIO_PORTD_DATA_R |= RAMCS_N;						// close NVRAM
-	ssiflag = 0;
-	while(!ssiflag);									// hold time (1/2 bit)
-	TIMER1_CTL_R &= ~(TIMER_CTL_TBEN);					// disable timer
+	nvr_pins(0);										// wait for the SSI to finish, pins back to GPIO
+	GPIO_PORTD_DATA_R |= RAMCS_N;						// close NVRAM (PB2 is now the LOCK sw)
+	nvr_closeus = get_us();
+	while(SSI3_SR_R & SSI_SR_RNE){						// the RX side is not wired, empty its FIFO
+		di = SSI3_DR_R;
+	}
 //	putchar_bQ('d');
 	return;
 }
 
+/****************
+ * nvr_lock_ok returns TRUE if PB2 is showing the LOCK switch (NVRAM is not
+ *	selected and the mux has settled since the last NVRAM message)
+ */
+U8 nvr_lock_ok(void)
+{
+
+	if(!(GPIO_PORTD_DATA_R & RAMCS_N)) return FALSE;
+	if((get_us() - nvr_closeus) < LOCK_SETTLE_US) return FALSE;
+	return TRUE;
+}
+
+/****************
+ * nvr_pins switches PD0/PD3 (SCK/MOSI) to SSI3 (ssi == 1) or GPIO (ssi == 0).
+ *	SCK idles low either way.
+ */
+void nvr_pins(U8 ssi)
+{
+
+	if(ssi == nvr_ssi) return;
+	if(ssi){
+		GPIO_PORTD_AFSEL_R |= (SCK | MOSI_N);			// SSI3 drives the pins
+	}else{
+		while(SSI3_SR_R & SSI_SR_BSY);					// wait for the TX FIFO to drain
+		GPIO_PORTD_DATA_R &= ~SCK;
+		GPIO_PORTD_AFSEL_R &= ~(SCK | MOSI_N);			// GPIO drives the pins
+	}
+	nvr_ssi = ssi;
+	nvr_wait_us(NVR_PIN_SETTLE_US);						// let the pins settle
+	return;
+}
+
+/****************
+ * nvr_wait_us waits at least "us" microseconds (WTimer5A timebase)
+ */
+void nvr_wait_us(U32 us)
+{
+	U32	t = get_us();
+
+	while((get_us() - t) <= us);
+	return;
+}
+
+/****************
+ * nvr_put queues a byte to the NVRAM on the SSI3 TX FIFO
+ */
+void nvr_put(U8 dato)
+{
+
+	nvr_pins(1);
+	while(!(SSI3_SR_R & SSI_SR_TNF));					// wait for FIFO space
+	SSI3_DR_R = dato;
+	return;
+}
+
+/****************
+ * nvr_get shifts a byte in from the NVRAM (and dato out) by software.  Each bit is
+ *	paced by NVR_MISO_SU_US (SCK high to MISO sample) and NVR_SCK_HD_US (SCK low),
+ *	so the read does not depend on the CPU clock or the PB2 loading (~200 KHz).
+ */
+U8 nvr_get(U8 dato)
+{
+	U8	i;
+	U8	datain = 0;
+	volatile U32	di;
+
+	nvr_pins(0);
+	for(i=0x80;i;i >>= 1){
+		if(i & dato) GPIO_PORTD_DATA_R |= MOSI_N;		// set MOSI
+		else GPIO_PORTD_DATA_R &= ~MOSI_N;				// clear MOSI
+		GPIO_PORTD_DATA_R |= SCK;						// clr SCK (NVRAM shifts out MISO)
+		nvr_wait_us(NVR_MISO_SU_US);					// MISO setup
+		di = GPIO_PORTB_DATA_R;							// dummy read covers the GPIO input synchronizer
+		if(GPIO_PORTB_DATA_R & MISO_LOCK) datain |= i;	// capture MISO == 1
+		GPIO_PORTD_DATA_R &= ~SCK;						// set SCK
+		nvr_wait_us(NVR_SCK_HD_US);						// hold
+	}
+	return datain;
+}
+
 /****************
  * wen_nvr sends write enable cmd to the NVRAM
  */
@@ -228,7 +333,7 @@ void wen_nvr(void)
 {
 
 	open_nvr();
-	shift_spi(WREN);
+	nvr_put(WREN);
 	close_nvr();
 	return;
 }
@@ -241,8 +346,8 @@ void storecall_nvr(U8 tf_fl)
 {
 
 	open_nvr();
-	if(tf_fl) shift_spi(STORE);
-	else shift_spi(RECALL);
+	if(tf_fl) nvr_put(STORE);
+	else nvr_put(RECALL);
 	close_nvr();
 	return;
 }
@@ -254,13 +359,16 @@ void storecall_nvr(U8 tf_fl)
  */
 U8 rws_nvr(U8 dataw, U8 mode)
 {
-	U8	i;		// temp
+	U8	i = 0;		// temp
 
-	if(mode & CS_WRITE) i = WRSR;
-	else i = RDSR;
 	open_nvr();
-	shift_spi(i);
-	i = shift_spi(dataw);
+	if(mode & CS_WRITE){
+		nvr_put(WRSR);
+		nvr_put(dataw);
+	}else{
+		nvr_put(RDSR);
+		i = nvr_get(dataw);
+	}
 	close_nvr();
 	return i;
 }
@@ -272,7 +380,7 @@ U8 rws_nvr(U8 dataw, U8 mode)
  *	if mode = OPEN, assert CS and sent r/w cmd and address
  *	if mode = CLOSE, de-assert CS at end
  *	else, just send/rx data byte
- *	set hi-bit of mode (CS_WRITE) to signal write
+ *	set hi-bit of mode (CS_WRITE) to signal write (writes return 0)
  */
 U8 rw8_nvr(U32 addr, U8 dataw, U8 mode)
 {
@@ -286,12 +394,17 @@ U8 rw8_nvr(U32 addr, U8 dataw, U8 mode)
 			i = READ;
 		}
 		open_nvr();
-		shift_spi(i);
-		shift_spi((U8)(addr >> 16));
-		shift_spi((U8)(addr >> 8));
-		shift_spi((U8)(addr));
+		nvr_put(i);
+		nvr_put((U8)(addr >> 16));
+		nvr_put((U8)(addr >> 8));
+		nvr_put((U8)(addr));
+	}
+	if(mode & CS_WRITE){
+		nvr_put(dataw);
+		i = 0;
+	}else{
+		i = nvr_get(dataw);
 	}
-	i = shift_spi(dataw);
 	if(mode & CS_CLOSE){
 		close_nvr();
 	}
@@ -313,7 +426,7 @@ U16 rw16_nvr(U32 addr, U16 dataw, U8 mode)
 	}
 	ii = (U16)rw8_nvr(addr, i, (mode&(CS_WRITE | CS_OPEN)) );
 	if(mode & CS_WRITE) i = (U8)(dataw >> 8);
-	ii |= ((U16)rw8_nvr(addr+1, i, mode & CS_CLOSE)) << 8;
+	ii |= ((U16)rw8_nvr(addr+1, i, mode & (CS_WRITE | CS_CLOSE))) << 8;
 	return ii;
 }
 
@@ -356,6 +469,45 @@ U32 rw32_nvr(U32 addr, U32 dataw, U8 mode)
 	return ii;
 }
 
+/****************
+ * nvr_read_block reads len bytes starting at addr from the NVRAM into dptr (one message)
+ */
+void nvr_read_block(U32 addr, U8* dptr, U16 len)
+{
+
+	if(!len) return;
+	open_nvr();
+	nvr_put(READ);
+	nvr_put((U8)(addr >> 16));
+	nvr_put((U8)(addr >> 8));
+	nvr_put((U8)(addr));
+	for( ; len; len--){
+		*dptr++ = nvr_get(0);
+	}
+	close_nvr();
+	return;
+}
+
+/****************
+ * nvr_write_block writes len bytes from sptr to the NVRAM starting at addr (one message)
+ */
+void nvr_write_block(U32 addr, const U8* sptr, U16 len)
+{
+
+	if(!len) return;
+	wen_nvr();
+	open_nvr();
+	nvr_put(WRITE);
+	nvr_put((U8)(addr >> 16));
+	nvr_put((U8)(addr >> 8));
+	nvr_put((U8)(addr));
+	for( ; len; len--){
+		nvr_put(*sptr++);
+	}
+	close_nvr();
+	return;
+}
+
 /****************
  * rwusn_nvr r/w NVRAM user seria#
  *
@@ -363,15 +515,19 @@ U32 rw32_nvr(U32 addr, U32 dataw, U8 mode)
 void rwusn_nvr(U8* dptr, U8 mode)
 {
 	U8	i;
-	U8	j;
 
 	if(mode&CS_WRITE) wen_nvr();
 	open_nvr();
-	if(mode&CS_WRITE) shift_spi(WRSNR);
-	else shift_spi(RDSNR);
-	for(i=0; i<16; i++, dptr++){
-		j = shift_spi(*dptr);
-		if(!(mode&CS_WRITE)) *dptr = j;
+	if(mode&CS_WRITE){
+		nvr_put(WRSNR);
+		for(i=0; i<16; i++){
+			nvr_put(*dptr++);
+		}
+	}else{
+		nvr_put(RDSNR);
+		for(i=0; i<16; i++, dptr++){
+			*dptr = nvr_get(0);
+		}
 	}
 	close_nvr();
 	return;
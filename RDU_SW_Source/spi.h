@@ -69,9 +69,10 @@ void open_spi(uint8_t addr);
 void close_spi(void);
 void spi1_clean(void);
 void lcd_cmd(U8 cmd);
-void send_so(uint32_t data);
+U8 send_so(uint32_t data);
 // NVRAM Fns
 void close_nvr(void);
+U8 nvr_lock_ok(void);
 void wen_nvr(void);
 void storecall_nvr(U8 tf_fl);
 U8 rws_nvr(U8 dataw, U8 mode);
@@ -79,6 +80,8 @@ U8 rw8_nvr(U32 addr, U8 dataw, U8 mode);
 U16 rw16_nvr(U32 addr, U16 dataw, U8 mode);
 U32 rw32_nvr(U32 addr, U32 dataw, U8 mode);
 void rwusn_nvr(U8* dptr, U8 mode);
+void nvr_read_block(U32 addr, U8* dptr, U16 len);
+void nvr_write_block(U32 addr, const U8* sptr, U16 len);
 void Timer1B_ISR(void);
 
 #endif /* SPI_H_ */
@@ -46,8 +46,10 @@ static void TIMER0AHandler(void);
 static void TIMER1AHandler(void);
 static void TIMER1BHandler(void);
 static void TIMER2AHandler(void);
+static void TIMER2BHandler(void);
 static void TIMER3AHandler(void);
-//static void TIMER3BHandler(void);
+static void SSI1Handler(void);
+static void TIMER3BHandler(void);
 static void IntDefaultHandler(void);
 
 //*****************************************************************************
@@ -125,7 +127,7 @@ void (* const g_pfnVectors[])(void) =
     TIMER1AHandler,                         //37 Timer 1 subtimer A
 	TIMER1BHandler,                      	//38 Timer 1 subtimer B
     TIMER2AHandler,                         //39 Timer 2 subtimer A
-    IntDefaultHandler,                      //40 Timer 2 subtimer B
+    TIMER2BHandler,                         //40 Timer 2 subtimer B
     IntDefaultHandler,                      //41 Analog Comparator 0
     IntDefaultHandler,                      //42 Analog Comparator 1
     IntDefaultHandler,                      //43 Analog Comparator 2
@@ -135,9 +137,9 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      //47 N/U GPIO Port G
     IntDefaultHandler,                      //48 N/U GPIO Port H
 	IntDefaultHandler,                      //49 UART2 Rx and Tx
-    IntDefaultHandler,                      //50 SSI1 Rx and Tx
+    SSI1Handler,                            //50 SSI1 Rx and Tx
 	TIMER3AHandler,                         //51 Timer 3 subtimer A
-    IntDefaultHandler,                      //52 Timer 3 subtimer B
+    TIMER3BHandler,                         //52 Timer 3 subtimer B (SW triggered, PTT fast path)
     IntDefaultHandler,                      //53 I2C1 Master and Slave
     IntDefaultHandler,                      //54 Quadrature Encoder 1
     IntDefaultHandler,                      //55 CAN0
@@ -388,6 +390,23 @@ TIMER2AHandler(void)
 	Timer2A_ISR();					// process timer2 interrupt
 }
 
+static void
+TIMER2BHandler(void)
+{
+	Timer2B_ISR();					// process timer2B interrupt
+}
+
+//*****************************************************************************
+//
+// This is the code that gets called when the processor receives a SSI1 intr.
+//
+//*****************************************************************************
+static void
+SSI1Handler(void)
+{
+	SSI1_ISR();						// process SSI1 interrupt (SOUT sequence engine)
+}
+
 //*****************************************************************************
 //
 // This is the code that gets called when the processor receives a TIMER3 intr.
@@ -398,12 +417,12 @@ TIMER3AHandler(void)
 {
 	Timer3A_ISR();					// process timer3A interrupt
 }
-/*
+
 static void
 TIMER3BHandler(void)
 {
-//	Timer3B_ISR();					// process timer3B interrupt
-}*/
+	Timer3B_ISR();					// process timer3B interrupt (PTT fast path)
+}
 
 //*****************************************************************************
 //
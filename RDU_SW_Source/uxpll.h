@@ -74,6 +74,26 @@
 #define PLL_1200_N		0x00040000L		// "code" bits for N frames
 #define PLL_1200_MASK	0x0003ffffL		// mask for N frames
 #define PLL_1200		0x19f64L		// must bit reverse
+// band descriptor PLL frame format flags
+#define	PLLF_SHL		0x01			// <<1 after adding freq (10M, 6M)
+#define	PLLF_INS		0x02			// insert a "0" into bit 6 (2M, 220, 1200)
+#define	PLLF_INIT		0x04			// leading init frame, PTT follows the "PTT on" state (10M, 6M)
+#define	PLLF_UX129		0x08			// UX-129 sequence: N-code, bit reverse, post-init frames (1200)
+
+// band descriptor, one per module ID (ID10M - ID1200).  Drives get_modulid() and pll_frames().
+struct band_desc_struct {
+	U16	mhz_lo;							// module range (MHz, inclusive)
+	U16	mhz_hi;
+	U16	nb_lo;							// ham band (MHz), outside of nb_lo - (nb_hi-1) sets wide-band RX
+	U16	nb_hi;
+	U32	base_rx;						// RX base freq (KHz)
+	U32	pll_base;						// PLL base bitmap
+	S32	tx_offs;						// TX offset (channels, signed)
+	U32	init;							// init frame
+	U8	chan;							// channel size (KHz)
+	U8	fmt;							// frame format (PLLF_xxx)
+};
+
 #define UX_XIT_MASK		0xf0000000L		// XIT code mask
 #define	UX_XIT			0x80000000L		// XIT code
 #define	UX_XIT_UP		0x00000010L		// XIT up code
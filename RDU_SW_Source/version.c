@@ -66,5 +66,5 @@ void ccmdSWvers(char* sbuf){
 //-----------------------------------------------------------------------------
 U16 nvram_sn(void){
 
-    return 0x0001;
+    return 0x0002;								// NVSN_V2: split mem hot/name layout
 }
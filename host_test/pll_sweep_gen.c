@@ -0,0 +1,260 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: pll_sweep_gen.c
+ *
+ *  Module:    Host test
+ *
+ *  Summary:
+ *  Golden value generator and regression harness for the PLL sweep
+ *  (pll_sweep() in radio.c).  Runs pll_sweep_pass() from pll_frm.c on the
+ *  host and checks:
+ *	- the frame stream CRC against PLL_SWEEP_CRC (radio.h),
+ *	- a CRC per band and mode against gold_bk[] below (a fail names the
+ *	  band and mode that changed),
+ *	- optionally, every frame against a stream file written by a baseline
+ *	  build (a fail names the first band, frequency and mode that changed).
+ *  It also times the sweep and reports ns/frame.
+ *
+ *  Build & run (from this directory):
+ *		gcc -O2 -Wall -I../RDU_SW_Source -o pll_sweep_gen pll_sweep_gen.c ../RDU_SW_Source/pll_frm.c
+ *		./pll_sweep_gen					check and time
+ *		./pll_sweep_gen -w <file>		also write the frame stream (baseline build)
+ *		./pll_sweep_gen -c <file>		also compare each frame to a baseline stream
+ *		./pll_sweep_gen -g				print gold_bk[] for this build
+ *
+ *  When a change to the PLL code is meant to alter the SOUT protocol, set
+ *  PLL_SWEEP_CRC and gold_bk[] to the values printed here.
+ *
+ *******************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "typedef.h"
+#include "init.h"
+#include "radio.h"
+#include "uxpll.h"
+
+#define	NMODES		16					// sweep modes (k) per frequency
+#define	TIME_RUNS	5					// timed passes (best is reported)
+#define	MID_NUM		2000				// get_modulid() check range (MHz)
+
+// per band, per mode frame CRCs (generated by "pll_sweep_gen -g")
+const U16 gold_bk[ID1200][NMODES] = {
+	{ 0xff03, 0x4031, 0x4043, 0xff71, 0x16f8, 0x0d6b, 0xe562, 0xfef1, 0xe50e, 0x2fae, 0x1694, 0xdc34, 0x3c77, 0xe7e2, 0xcfed, 0x1478 },	// 10M
+	{ 0x19e5, 0x4d11, 0x10cd, 0x4439, 0xa69f, 0x196d, 0x3eb9, 0x814b, 0x21c9, 0x9e3b, 0xb9ef, 0x061d, 0x9dae, 0x25a7, 0x0588, 0xbd81 },	// 6M
+	{ 0xa935, 0x6c69, 0xa2a7, 0x67fb, 0xe94a, 0xf7c4, 0x9d40, 0x83ce, 0xc808, 0xd686, 0xbc02, 0xa28c, 0xe938, 0xf7b6, 0x9d32, 0x83bc },	// 2M
+	{ 0x0461, 0x41de, 0x2098, 0x6527, 0x96b8, 0xc26b, 0xaf77, 0xfba4, 0xb42d, 0xe0fe, 0x8de2, 0xd931, 0x2e06, 0x7ad5, 0x17c9, 0x431a },	// 220
+	{ 0x39c0, 0x4562, 0x2bdd, 0x577f, 0xf4e3, 0x2cf1, 0xd18e, 0x099c, 0x6807, 0xb015, 0x4d6a, 0x9578, 0xfd85, 0x67e3, 0xd8e8, 0x428e },	// 440
+	{ 0xb7be, 0x2fa2, 0x0c3c, 0x9420, 0x6d49, 0xb015, 0xf0a6, 0x2dfa, 0x9415, 0x4949, 0x09fa, 0xd4a6, 0x3c53, 0xe10f, 0xa1bc, 0x7ce0 }	// 1200
+};
+
+const char* band_name[ID1200] = { "10M", "6M", "2M", "220", "440", "1200" };
+const char* mode_name[4] = { "RX", "TX S", "TX +", "TX -" };
+
+U16		bk_crc[ID1200][NMODES];			// per band, per mode CRCs of this build
+FILE*	wfp;							// stream output (-w)
+FILE*	cfp;							// baseline stream input (-c)
+U32		ndiff;							// frame sequences that differ from the baseline
+U8		cend;							// baseline stream ended early
+
+//-----------------------------------------------------------------------------
+// calcrc() calculates the crc16 of a byte, same as calcrc() in radio.c
+//-----------------------------------------------------------------------------
+U16 calcrc(U8 c, U16 oldcrc){
+	U16 crc;
+	U8	i;
+
+	crc = oldcrc ^ ((U16)c << 8);
+	for (i = 0; i < 8; ++i){
+		if (crc & 0x8000) crc = (crc << 1) ^ XPOLY;
+		else crc = crc << 1;
+	}
+	return crc;
+}
+
+//-----------------------------------------------------------------------------
+// put_mode() prints band, frequency and mode k of a frame sequence
+//-----------------------------------------------------------------------------
+void put_mode(U8 bid, U32 f, U8 k){
+
+	printf("band %s, %u KHz, k %d (%s, %s, %s)", band_name[bid], f, k,
+		   mode_name[k >> 2], (k & 0x02) ? "low pwr" : "high pwr", (k & 0x01) ? "main" : "sub");
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// sweep_fn() is called by pll_sweep_pass() for each frame sequence.  Folds it into
+//	the band/mode CRC, and writes it to, or compares it with, a stream file.
+//	Stream record: bid, k, len, 0, f (U32), frames (U32 x len), host byte order.
+//-----------------------------------------------------------------------------
+void sweep_fn(U8 bid, U32 f, U8 k, U32* fptr, U8 len){
+	U8	hdr[4];
+	U8	rhdr[4];
+	U32	rf;
+	U32	rbuf[PLLC_LEN];
+	U8	i;
+
+	for(i=0; i<len; i++){
+		bk_crc[bid][k] = calcrc((U8)(fptr[i]), bk_crc[bid][k]);
+		bk_crc[bid][k] = calcrc((U8)(fptr[i] >> 8), bk_crc[bid][k]);
+		bk_crc[bid][k] = calcrc((U8)(fptr[i] >> 16), bk_crc[bid][k]);
+		bk_crc[bid][k] = calcrc((U8)(fptr[i] >> 24), bk_crc[bid][k]);
+	}
+	hdr[0] = bid;
+	hdr[1] = k;
+	hdr[2] = len;
+	hdr[3] = 0;
+	if(wfp){
+		fwrite(hdr, 1, 4, wfp);
+		fwrite(&f, sizeof(U32), 1, wfp);
+		fwrite(fptr, sizeof(U32), len, wfp);
+	}
+	if(cfp && !cend){
+		if((fread(rhdr, 1, 4, cfp) != 4) || (fread(&rf, sizeof(U32), 1, cfp) != 1) || (rhdr[2] > PLLC_LEN)
+			|| (fread(rbuf, sizeof(U32), rhdr[2], cfp) != rhdr[2])){
+			printf("baseline stream ends at ");
+			put_mode(bid, f, k);
+			printf("\n");
+			cend = 1;
+			ndiff++;
+			return;
+		}
+		if(memcmp(hdr, rhdr, 4) || (f != rf) || memcmp(fptr, rbuf, len * sizeof(U32))){
+			if(!ndiff){
+				printf("first difference: ");
+				put_mode(bid, f, k);
+				printf("\n\tgot     ");
+				for(i=0; i<len; i++) printf(" %08x", fptr[i]);
+				printf("\n\tbaseline");
+				if((rhdr[0] != bid) || (rhdr[1] != k) || (rf != f)){
+					printf(" (at ");
+					put_mode(rhdr[0], rf, rhdr[1]);
+					printf(")");
+				}
+				for(i=0; i<rhdr[2]; i++) printf(" %08x", rbuf[i]);
+				printf("\n");
+			}
+			ndiff++;
+		}
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// mid_check() writes or compares the get_modulid() table (0 - MID_NUM MHz)
+//-----------------------------------------------------------------------------
+void mid_check(void){
+	U8	mid[MID_NUM];
+	U8	rmid[MID_NUM];
+	U32	f;
+
+	for(f=0; f<MID_NUM; f++){
+		mid[f] = get_modulid(f);
+	}
+	if(wfp) fwrite(mid, 1, MID_NUM, wfp);
+	if(cfp && !cend){
+		if(fread(rmid, 1, MID_NUM, cfp) != MID_NUM){
+			printf("baseline stream has no get_modulid() table\n");
+			ndiff++;
+			return;
+		}
+		for(f=0; f<MID_NUM; f++){
+			if(mid[f] != rmid[f]){
+				printf("get_modulid(%u MHz): got %02x, baseline %02x\n", f, mid[f], rmid[f]);
+				ndiff++;
+				break;
+			}
+		}
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// time_sweep() times pll_sweep_pass() (no crc, no callback, like the timed pass of
+//	pll_sweep()) and returns the best ns/frame of TIME_RUNS passes
+//-----------------------------------------------------------------------------
+double time_sweep(void){
+	struct timespec	t0;
+	struct timespec	t1;
+	double	ns;
+	double	best = 0;
+	U32		n;
+	U8		i;
+
+	for(i=0; i<TIME_RUNS; i++){
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		n = pll_sweep_pass(0, 0);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec);
+		ns /= (double)n;
+		if((i == 0) || (ns < best)) best = ns;
+	}
+	return best;
+}
+
+int main(int argc, char* argv[]){
+	FILE*	fp;
+	U16		crc = 0;
+	U32		n;
+	U32		bkf = 0;
+	U8		gen = 0;
+	U8		j;
+	U8		k;
+	int		a;
+
+	for(a=1; a<argc; a++){
+		if(!strcmp(argv[a], "-g")){
+			gen = 1;
+		}else{
+			if(((!strcmp(argv[a], "-w")) || (!strcmp(argv[a], "-c"))) && (a + 1 < argc)){
+				fp = fopen(argv[a + 1], (argv[a][1] == 'w') ? "wb" : "rb");
+				if(argv[a][1] == 'w') wfp = fp;
+				else cfp = fp;
+				if(!fp){
+					printf("can't open %s\n", argv[a + 1]);
+					return 1;
+				}
+				a++;
+			}else{
+				printf("usage: pll_sweep_gen [-g] [-w <file>] [-c <file>]\n");
+				return 1;
+			}
+		}
+	}
+	n = pll_sweep_pass(&crc, sweep_fn);
+	mid_check();
+	if(gen){
+		printf("const U16 gold_bk[ID1200][NMODES] = {\n");
+		for(j=0; j<ID1200; j++){
+			printf("\t{");
+			for(k=0; k<NMODES; k++){
+				printf(" 0x%04x%s", bk_crc[j][k], (k < NMODES - 1) ? "," : " ");
+			}
+			printf("}%s\t// %s\n", (j < ID1200 - 1) ? "," : "", band_name[j]);
+		}
+		printf("};\n");
+	}
+	for(j=0; j<ID1200; j++){
+		for(k=0; k<NMODES; k++){
+			if(bk_crc[j][k] != gold_bk[j][k]){
+				if(!gen){
+					printf("band/mode CRC fail: band %s, k %d (%s, %s, %s): %04x, golden %04x\n",
+						   band_name[j], k, mode_name[k >> 2], (k & 0x02) ? "low pwr" : "high pwr",
+						   (k & 0x01) ? "main" : "sub", bk_crc[j][k], gold_bk[j][k]);
+				}
+				bkf++;
+			}
+		}
+	}
+	if(wfp) fclose(wfp);
+	if(cfp){
+		fclose(cfp);
+		printf("baseline compare: %u frame sequences differ\n", ndiff);
+	}
+	printf("PLL sweep: %u frames, %.1f ns/frame (host)\n", n, time_sweep());
+	printf("CRC %04x (PLL_SWEEP_CRC %04x), %u band/mode CRC fails %s\n", crc, PLL_SWEEP_CRC, bkf,
+		   ((crc == PLL_SWEEP_CRC) && !bkf && !ndiff) ? "PASS" : "FAIL");
+	return ((crc == PLL_SWEEP_CRC) && !bkf && !ndiff) ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: sin_dec_test.c
+ *
+ *  Module:    Host test
+ *
+ *  Summary:
+ *  Host-side check of the SIN edge-timestamp decoder (sin_decode() and
+ *  sin_start_ok() in sin_dec.c) against a model of the old Timer2A bit
+ *  sampler (sample at the middle of each bit, measured from the start edge).
+ *
+ *  Build & run (from this directory):
+ *		gcc -Wall -I../RDU_SW_Source -o sin_dec_test sin_dec_test.c ../RDU_SW_Source/sin_dec.c
+ *		./sin_dec_test [edge file]
+ *
+ *  The edge file holds recorded edge streams, one frame per line:
+ *		<expected word> <edge 0> <edge 1> ...		(hex, Timer2A capture values)
+ *	An expected word of 0 means the frame must be rejected.  Lines starting
+ *	with '#' are comments.  Without a file, the built-in streams are run.
+ *
+ *******************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "typedef.h"
+#include "init.h"
+#include "sio.h"
+
+#define	NBITS		(SIN_DATA_BITS + 1)		// start bit + data bits
+#define	RAND_RUNS	20000
+
+U32	fails;
+U32	checks;
+
+//-----------------------------------------------------------------------------
+// mkedges() builds the edge stream of a SIN word.  t0 is the start edge timestamp
+//	(down-counting 24b timer).  jit (counts) is added to each edge, alternating
+//	sign.  gpos/gw insert a high-going glitch of width gw at gpos counts after the
+//	start edge (gw = 0 for none).  Returns the edge count.
+//-----------------------------------------------------------------------------
+U8 mkedges(U32 word, U32 t0, U32 jit, U32 gpos, U32 gw, U32* eptr){
+	U32	t[SIN_EDGE_MAX + 4];		// edge times after t0
+	U8	n = 0;
+	U8	i;
+	U8	lvl = 0;					// line level after the start edge
+	U8	b;
+	U32	mask = SIN_START >> 1;
+
+	t[n++] = 0;
+	for(i=1; i<NBITS; i++, mask >>= 1){
+		b = (word & mask) ? 1 : 0;
+		if(b != lvl){
+			t[n] = (i * SIN_BIT_TIME) + ((n & 1) ? jit : -jit);
+			n++;
+			lvl = b;
+		}
+	}
+	if(!lvl) t[n++] = NBITS * SIN_BIT_TIME;			// rising edge into the stop bits
+	if(gw){											// insert a glitch (two edges) in time order
+		for(i=n; i && (t[i-1] > gpos); i--){
+			t[i+1] = t[i-1];
+		}
+		t[i] = gpos;
+		t[i+1] = gpos + gw;
+		n += 2;
+	}
+	for(i=0; i<n; i++){
+		eptr[i] = (t0 - t[i]) & SIN_TSTAMP_MASK;
+	}
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+// old_sampler() models the Timer2A bit sampler: the start bit is checked at the
+//	half-bit point, then each bit is sampled one bit time later.  Returns the SIN
+//	word, or 0 for a framing error.
+//-----------------------------------------------------------------------------
+U32 old_sampler(U32* eptr, U8 n){
+	U32	dr = 0;
+	U32	mask = SIN_START;
+	U32	ts = SIN_HALF_BIT_TIME;
+	U8	j = 1;
+	U8	lvl = 0;
+
+	do{
+		while((j < n) && (((eptr[0] - eptr[j]) & SIN_TSTAMP_MASK) < ts)){
+			lvl ^= 1;
+			j++;
+		}
+		if(mask == SIN_START){
+			if(lvl) return 0;
+		}else{
+			if(lvl) dr |= mask;
+		}
+		mask >>= 1;
+		ts += SIN_BIT_TIME;
+	}while(mask != 0x2000L);
+	return dr | 0x3fffL;
+}
+
+//-----------------------------------------------------------------------------
+// check() compares a result against the expected value
+//-----------------------------------------------------------------------------
+void check(const char* name, U32 got, U32 exp){
+
+	checks++;
+	if(got != exp){
+		fails++;
+		printf("FAIL %s: got %08x, expected %08x\n", name, got, exp);
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// decode() runs an edge stream through the ISR start check and sin_decode()
+//-----------------------------------------------------------------------------
+U32 decode(U32* eptr, U8 n, U8 vote){
+	U8	g;
+
+	if((n > 1) && !sin_start_ok(eptr[0], eptr[1])) return 0;
+	return sin_decode(eptr, n, vote, &g);
+}
+
+//-----------------------------------------------------------------------------
+// run_builtin() runs the built-in edge streams
+//-----------------------------------------------------------------------------
+void run_builtin(void){
+	U32	e[SIN_EDGE_MAX + 4];
+	U32	w;
+	U32	t0;
+	U32	r;
+	U8	n;
+	U8	g;
+	U8	v;
+	int	k;
+	static const U32 words[] = {
+		0x7fffffffL, 0x00003fffL, 0x40003fffL, 0x2aaaffffL, 0x5555bfffL,
+		0x60003fffL, 0x3c7fffffL, 0x4207ffffL
+	};
+
+	// fixed words, clean and with timer wrap
+	for(k=0; k<(int)(sizeof(words)/sizeof(words[0])); k++){
+		for(v=0; v<2; v++){
+			n = mkedges(words[k], 0x00ffffffL, 0, 0, 0, e);
+			check("clean", decode(e, n, v), words[k]);
+			check("clean/old", old_sampler(e, n), words[k]);
+			n = mkedges(words[k], 0x00000100L, 0, 0, 0, e);	// 24b timer wraps inside the frame
+			check("wrap", decode(e, n, v), words[k]);
+		}
+	}
+	// false start: a short low pulse is rejected by the start check
+	e[0] = 0x800000L;
+	e[1] = e[0] - (SIN_START_MIN / 4);
+	check("false start", decode(e, 2, 0), 0);
+	check("start ok", sin_start_ok(e[0], e[0] - SIN_BIT_TIME), TRUE);
+	// glitch away from the mid-bit point: decoded with vote, counted as a glitch
+	w = 0x00003fffL;
+	n = mkedges(w, 0x400000L, 0, (3 * SIN_BIT_TIME) + (SIN_BIT_TIME / 4) - 50, 100, e);
+	check("glitch/vote", decode(e, n, 1), w);
+	sin_decode(e, n, 1, &g);
+	check("glitch count", g, 1);
+	// glitch on the mid-bit point: mid-bit sampling takes the glitch, the vote rejects it
+	n = mkedges(w, 0x400000L, 0, (3 * SIN_BIT_TIME) + SIN_HALF_BIT_TIME - 50, 100, e);
+	check("glitch/mid", decode(e, n, 0), old_sampler(e, n));
+	check("glitch/mid vote", decode(e, n, 1), w);
+	// too many edges is a framing error
+	check("edge overflow", sin_decode(e, SIN_EDGE_MAX + 1, 0, &g), 0);
+	// random words with edge jitter: new decoder == old sampler == source word
+	srand(900);
+	for(k=0; k<RAND_RUNS; k++){
+		w = ((((U32)rand() << 16) ^ (U32)rand()) & 0x7fffc000L) | 0x3fffL;
+		t0 = (((U32)rand() << 8) ^ (U32)rand()) & SIN_TSTAMP_MASK;
+		n = mkedges(w, t0, rand() % (SIN_VOTE_TIME / 2), 0, 0, e);
+		r = decode(e, n, k & 1);
+		if(r != old_sampler(e, n)) check("random/old", r, old_sampler(e, n));
+		if(r != w) check("random", r, w);
+		checks++;
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// run_file() runs recorded edge streams from a file
+//-----------------------------------------------------------------------------
+void run_file(const char* fname){
+	FILE*	fp;
+	char	line[512];
+	char*	tok;
+	U32		e[SIN_EDGE_MAX + 1];
+	U32		w;
+	U8		n;
+	U8		v;
+
+	fp = fopen(fname, "r");
+	if(!fp){
+		printf("can't open %s\n", fname);
+		fails++;
+		return;
+	}
+	while(fgets(line, sizeof(line), fp)){
+		if((line[0] == '#') || (line[0] == '\n')) continue;
+		tok = strtok(line, " \t\r\n");
+		if(!tok) continue;
+		w = strtoul(tok, NULL, 16);
+		n = 0;
+		while((tok = strtok(NULL, " \t\r\n")) && (n <= SIN_EDGE_MAX)){
+			e[n++] = strtoul(tok, NULL, 16) & SIN_TSTAMP_MASK;
+		}
+		for(v=0; v<2; v++){
+			check(fname, decode(e, n, v), w);
+		}
+		if(w) check("old", old_sampler(e, n), w);
+	}
+	fclose(fp);
+	return;
+}
+
+int main(int argc, char* argv[]){
+
+	if(argc > 1) run_file(argv[1]);
+	else run_builtin();
+	printf("%u checks, %u failures\n", checks, fails);
+	return fails ? 1 : 0;
+}
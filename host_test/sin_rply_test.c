@@ -0,0 +1,201 @@
+/********************************************************************
+ ************ COPYRIGHT (c) 2021 by ke0ff, Taylor, TX   *************
+ *
+ *  File name: sin_rply_test.c
+ *
+ *  Module:    Host test
+ *
+ *  Summary:
+ *  Host-side SIN replay.  A recorded SIN stream is loaded into the capture
+ *  buffer (sin_cap.c) and replayed at its recorded pacing on a simulated
+ *  1 ms clock.  Each frame goes through the same steps as on target:
+ *  the SEND edge check that pends the PTT fast path (sin_send_edge() in
+ *  sin_dec.c), then the process_SIN() flag logic (sin_word() in sin_evt.c)
+ *  and the SIN event queue.  The posted events are listed per frame, and
+ *  every SEV_PTT event must match a SEND edge (a mismatch is a dropped or
+ *  phantom PTT).
+ *
+ *  Build & run (from this directory):
+ *		gcc -Wall -I../RDU_SW_Source -o sin_rply_test sin_rply_test.c ../RDU_SW_Source/sin_cap.c ../RDU_SW_Source/sin_evt.c ../RDU_SW_Source/sin_dec.c
+ *		./sin_rply_test [scap dump file]
+ *
+ *  The dump file is the output of the CLI "SCAP D" command, one frame per line:
+ *		<dt ms> <hex word>
+ *	Other lines ("SCAP n=", "SCAP end", '#' comments) are skipped.  Without a
+ *	file, the built-in stream is run and checked.
+ *
+ *******************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "typedef.h"
+#include "init.h"
+#include "sio.h"
+#include "radio.h"
+
+U32	fails;
+U32	checks;
+U32	sends;						// SEND edges (PTT fast path triggers)
+U32	ptts;						// SEV_PTT events
+U32	bads;						// frames rejected by sin_word()
+
+const char* sev_name[SEV_NUM] = {
+	"PTT", "COSM", "COSS", "SRFM", "SRFS", "DSQA", "DSQB", "MCK", "MUP", "SEL", "BUSY"
+};
+
+// built-in stream: recorded time, word, and the expected replay result
+struct rply_case {
+	U32			dt;
+	U32			word;
+	const char*	exp;
+};
+
+const struct rply_case builtin[] = {
+	{    0, 0x0000ffffL, "" },						// addr 0 idle
+	{    5, 0x4000ffffL, "" },						// addr 1 idle
+	{   10, 0x4000ffffL, "" },						// repeat
+	{   15, 0x6000ffffL, "SEND PTT=1" },			// PTT on
+	{   20, 0x00000000L, "bad" },					// framing error
+	{   25, 0x1000ffffL, "COSM=1" },
+	{   30, 0x1080ffffL, "SRFM=1" },
+	{   35, 0x6000ffffL, "" },						// repeat, PTT held
+	{   40, 0x4000ffffL, "SEND PTT=0" },			// PTT off
+	{   45, 0x6000fffeL, "bad" },					// bad stop bits: no SEND edge either
+	{   50, 0x0800ffffL, "COSM=0 COSS=1 SRFM=0" },
+	{ 2000, 0x6000ffffL, "SEND PTT=1" }				// long gap
+};
+
+//-----------------------------------------------------------------------------
+// take() runs one replayed frame through the target SIN path and puts the
+//	result (SEND edge, bad frame, posted events) into rbuf
+//-----------------------------------------------------------------------------
+void take(U32 ii, char* rbuf){
+	U16	ev;
+	U8	e;
+	U8	i;
+	U8	np = 0;
+
+	rbuf[0] = '\0';
+	e = sin_send_edge(ii);						// Timer2B_ISR()/rply_get(): PTT fast path
+	if(e){
+		sends++;
+		strcat(rbuf, "SEND");
+	}
+	if(!sin_word(ii)){							// process_SIN()
+		bads++;
+		if(rbuf[0]) strcat(rbuf, " ");
+		strcat(rbuf, "bad");
+	}
+	while(get_sin_event(SEVC_UI, &ev)){
+		i = SEV_ID(ev);
+		if(rbuf[0]) strcat(rbuf, " ");
+		sprintf(rbuf + strlen(rbuf), "%s=%d", (i < SEV_NUM) ? sev_name[i] : "?", SEV_VAL(ev));
+	}
+	while(get_sin_event(SEVC_SOUT, &ev)){		// process_SOUT() PTT detect
+		if(SEV_ID(ev) == SEV_PTT){
+			ptts++;
+			np++;
+			if(SEV_VAL(ev) != get_sin_send()){
+				printf("FAIL: PTT event %d, SEND state %d\n", SEV_VAL(ev), get_sin_send());
+				fails++;
+			}
+		}
+	}
+	while(get_sin_event(SEVC_MIC, &ev));
+	checks++;
+	if(np != e){
+		printf("FAIL: %d PTT events, %d SEND edges (dropped/phantom PTT)\n", np, e);
+		fails++;
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// replay() replays the capture buffer on a simulated 1 ms clock.  If cptr is not
+//	0, each frame is checked against the built-in case list, else it is listed.
+//-----------------------------------------------------------------------------
+void replay(const struct rply_case* cptr){
+	char	rbuf[80];
+	U32		t = 1000;							// replay start time
+	U32		ii;
+	U32		age;
+	U16		k = 0;
+
+	init_sin_event();							// process_SIN(PROC_INIT)
+	sin_addr0 = 0;
+	sin_addr1 = 0;
+	if(!sin_rply_start(t)){
+		printf("empty stream\n");
+		return;
+	}
+	while(sin_rply_on()){
+		if(sin_rply_end()){
+			sin_rply_stop();					// rply_rdy(): end of replay
+			continue;
+		}
+		while(sin_rply_due(t)){
+			ii = sin_rply_next(t, &age);
+			take(ii, rbuf);
+			if(cptr){
+				checks++;
+				if(strcmp(rbuf, cptr[k].exp) || ((t - 1000) != cptr[k].dt) || age){
+					printf("FAIL frame %d (%08x): got \"%s\" at %u ms, expected \"%s\" at %u ms\n",
+						k, ii, rbuf, t - 1000, cptr[k].exp, cptr[k].dt);
+					fails++;
+				}
+			}else{
+				printf("%6u %08x %s\n", t - 1000, ii, rbuf);
+			}
+			k++;
+		}
+		t++;
+	}
+	return;
+}
+
+//-----------------------------------------------------------------------------
+// load_file() loads a "SCAP D" dump into the capture buffer
+//-----------------------------------------------------------------------------
+U8 load_file(const char* fname){
+	FILE*	fp;
+	char	line[128];
+	unsigned int	dt;
+	unsigned int	w;
+
+	fp = fopen(fname, "r");
+	if(!fp){
+		printf("can't open %s\n", fname);
+		return FALSE;
+	}
+	while(fgets(line, sizeof(line), fp)){
+		if((line[0] < '0') || (line[0] > '9')) continue;
+		if(sscanf(line, "%u %x", &dt, &w) != 2) continue;
+		if(!sin_cap_put(dt, w)){
+			printf("stream longer than SIN_CAP_MAX (%d frames)\n", SIN_CAP_MAX);
+			break;
+		}
+	}
+	fclose(fp);
+	return TRUE;
+}
+
+int main(int argc, char* argv[]){
+	U16	k;
+
+	fails = 0;
+	checks = 0;
+	sin_cap_init();
+	if(argc > 1){
+		if(!load_file(argv[1])) return 1;
+		replay(0);
+	}else{
+		for(k=0; k<(U16)(sizeof(builtin)/sizeof(builtin[0])); k++){
+			sin_cap_put(builtin[k].dt, builtin[k].word);
+		}
+		replay(builtin);
+	}
+	printf("%d frames, %u bad, %u SEND edges, %u PTT events, %u evq overruns\n",
+		sin_cap_len(), bads, sends, ptts, get_sin_evor(0));
+	printf("%s: %u checks, %u failures\n", fails ? "FAIL" : "PASS", checks, fails);
+	return fails ? 1 : 0;
+}